@@ -7,14 +7,25 @@ out_name="${out_name%.*}"
 
 cpp_version=-std=c++20
 warnings='-Wall -Wextra -Wpedantic -Werror'
+includes='-I../Pulse/src'
 input_file=$1
 target_dir=bin
 
+# Benchmarks are optimised and use Google Benchmark
+optimise=''
+libraries=''
+case $input_file in
+    *_bench.cpp)
+        optimise='-O2'
+        libraries='-lbenchmark -pthread'
+        ;;
+esac
+
 mkdir -p $target_dir
 
 echo "Building ${out_name}..."
 
-c++ $cpp_version $warnings $input_file -o $target_dir/$out_name
+c++ $cpp_version $optimise $includes $warnings $input_file $libraries -o $target_dir/$out_name
 
 echo 'Done!'
 
@@ -1,8 +1,11 @@
 #include <iostream>
 #include <cstdint>
+#include <cmath>
 #include <vector>
+#include <algorithm>
 #include <numeric>
 #include <string>
+#include <stdexcept>
 
 namespace env {
 auto reverse_bit(std::size_t b, std::size_t bit_size) -> std::size_t {
@@ -0,0 +1,106 @@
+/**
+ * @file   rbit_bench.cpp
+ * @author Pratchaya Khansomboon (pratchaya.k.git@gmail.com)
+ * @brief  Benchmark of the bit reversal permutation, the bit by bit loop of
+ *         rbit.cpp and fft_i against Pulse/src/bit_reverse.hpp.
+ * @date   2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+#include <cstdint>
+#include <cstddef>
+
+#include <bit>
+#include <complex>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "bit_reverse.hpp"
+
+using value_type = std::complex<double>;
+
+namespace env {
+// Same loop as env::reverse_bit in rbit.cpp and the lambda in fft_i
+auto reverse_bit(std::size_t b, std::size_t bit_size) -> std::size_t {
+    std::size_t n = 0;
+    for (std::size_t i = 0; i < bit_size; ++i) {
+        n = n << 1;
+        n = n | (b & 1);
+        b = b >> 1;
+    }
+    return n;
+}
+
+auto make_samples(std::size_t const& size) -> std::vector<value_type> {
+    std::vector<value_type> samples(size);
+    for (std::size_t i = 0; i < size; i++) samples[i] = {double(i), -double(i)};
+    return samples;
+}
+}
+
+// fft_i: gather into a fresh array, reversing every index bit by bit
+static auto bm_loop_gather(benchmark::State& state) -> void {
+    auto const N    = std::size_t(state.range(0));
+    auto const bits = std::size_t(std::countr_zero(N));
+    auto const in   = env::make_samples(N);
+    for (auto _ : state) {
+        std::vector<value_type> out(N);
+        for (std::size_t i = 0; i < N; i++) out[i] = in[env::reverse_bit(i, bits)];
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * std::int64_t(N));
+}
+
+// Precomputed swap pairs, what fft_plan keeps for small sizes
+static auto bm_swap_pairs(benchmark::State& state) -> void {
+    auto const N = std::size_t(state.range(0));
+    auto data = env::make_samples(N);
+    auto const pairs = nrv::bit_reverse_pairs(N);
+    for (auto _ : state) {
+        nrv::bit_reverse_permute(std::span(data), std::span(pairs));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * std::int64_t(N));
+}
+
+// Byte table lookups, scattered writes
+static auto bm_table_scatter(benchmark::State& state) -> void {
+    auto const N    = std::size_t(state.range(0));
+    auto const bits = std::size_t(std::countr_zero(N));
+    auto const in   = env::make_samples(N);
+    std::vector<value_type> out(N);
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < N; i++) out[nrv::reverse_bits(i, bits)] = in[i];
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * std::int64_t(N));
+}
+
+static auto bm_permute(benchmark::State& state) -> void {
+    auto const N = std::size_t(state.range(0));
+    auto data = env::make_samples(N);
+    for (auto _ : state) {
+        nrv::bit_reverse_permute(std::span(data));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * std::int64_t(N));
+}
+
+static auto bm_copy(benchmark::State& state) -> void {
+    auto const N  = std::size_t(state.range(0));
+    auto const in = env::make_samples(N);
+    std::vector<value_type> out(N);
+    for (auto _ : state) {
+        nrv::bit_reverse_copy(std::span(in), std::span(out));
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * std::int64_t(N));
+}
+
+BENCHMARK(bm_loop_gather)->RangeMultiplier(4)->Range(1 << 8, 1 << 22);
+BENCHMARK(bm_swap_pairs)->RangeMultiplier(4)->Range(1 << 8, 1 << 22);
+BENCHMARK(bm_table_scatter)->RangeMultiplier(4)->Range(1 << 8, 1 << 22);
+BENCHMARK(bm_permute)->RangeMultiplier(4)->Range(1 << 8, 1 << 22);
+BENCHMARK(bm_copy)->RangeMultiplier(4)->Range(1 << 8, 1 << 22);
+
+BENCHMARK_MAIN();
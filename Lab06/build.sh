@@ -3,6 +3,7 @@
 # REQUIRES:
 #     pkg-config
 #     fmt - https://fmt.dev/
+#     Google Benchmark for *_bench.cpp - https://github.com/google/benchmark
 
 set -e
 
@@ -20,18 +21,27 @@ bin=bin
 
 cpp_version=-std=c++20
 warnings='-Wall -Wextra -Wpedantic -Werror'
-includes="$(pkg-config --cflags fmt)"
-libraries="$(pkg-config --libs fmt)"
+includes="$(pkg-config --cflags fmt) -I../Pulse/src"
+libraries="$(pkg-config --libs fmt) -pthread"
 
 input=$1
 out="${input%.*}"
 target=${bin}/${out}
 
+# Benchmarks are optimised and use Google Benchmark
+optimise=''
+case $input in
+    *_bench.cpp)
+        optimise='-O2'
+        libraries="$libraries -lbenchmark"
+        ;;
+esac
+
 mkdir -p $bin
 
 printf "Building ${out} (*′☉.̫☉)..."
 
-c++ $cpp_version $includes $libraries $warnings $input -o $target
+c++ $cpp_version $optimise $includes $warnings $input $libraries -o $target
 
 printf ' Done! (^～^)\n'
 
@@ -16,116 +16,17 @@
 #include <fstream>
 #include <complex>
 #include <array>
+#include <limits>
 #include <string>
+#include <string_view>
 #include <numbers>
+#include <random>
 
 #include "fmt/format.h"
-
-using f64 = double;
-using fft_type = std::complex<f64>;
-using fft_vec  = std::vector<fft_type>;
-
-namespace nrv {
-    [[maybe_unused]]inline constexpr auto pi = std::numbers::pi;
-}
-
-/**
- * FFT recursive algorithm uses the classic divide and conquer algorithm. Which
- * makes it a straight forward to implement. With complexity O(N * log_2(N)).
- * However, the space complexity of this implementation is very good, the
- * function is called twice in every recursion and in total an array of length
- * 2^n has to be stored n times. This leads to space complexity of O(2^n * n).
- */
-auto fft_r(fft_vec const& samples) -> fft_vec {
-    using namespace std::complex_literals;
-    auto const N = samples.size();
-    if (N == 1) return samples;
-
-    // Split by the middle
-    auto const m = N / 2;
-
-    // Generate 'Even' and 'Odd' list of complex numbers with
-    // the size half of the sample size.
-    fft_vec x_e(m, 0.0);  // Even samples
-    fft_vec x_o(m, 0.0);  // Odd samples
-    // Split the samples for the 'Even' and 'Odd' DFT
-    for (std::size_t i = 0; i < m; i++) {
-        x_e[i] = samples[2 * i];      // Even: x_{2m}
-        x_o[i] = samples[2 * i + 1];  // Odd:  x_{2m + 1}
-    }
-
-    // Recursively split the rest of Evens and Odds
-    fft_vec const f_e = fft_r(x_e);
-    fft_vec const f_o = fft_r(x_o);
-
-    // Compute the DFT
-    fft_vec res(N, 0.0);
-    for (std::size_t k = 0; k < m; k++) {
-        auto const c = std::exp(-2.0i * nrv::pi * f64(k) / f64(N)) * f_o[k];
-
-        res[k]     = f_e[k] + c;
-        res[k + m] = f_e[k] - c;
-    }
-
-    return res;
-}
-
-/**
- * FFT iterative algorithm is not as straight forward as the recursive. The data
- * is divided into two arrays. The first one contains all even and the second
- * one all odd indices. If apply again to the subproblems, there are four arrays.
- * This is the FFT algorithm. For sample count of N = 8, the permutation is
- * log_2(N) = 3. The method is constructed for arbitrary N = 2^n.
- *
- * The rearrange in the manner that'll solve the problem can be done with
- * 'bit inversion'/'reverse bit'. This means that the index k is written in
- * binary representation and then read backwards.
- */
-auto fft_i(fft_vec const& samples) -> fft_vec {
-    using namespace std::complex_literals;
-    auto const N = samples.size();
-
-    // Reverse the bits, N = 2^n
-    // This is call radix-2 algorithm.
-    auto const BIT_SIZE = std::log(N) / std::log(2);
-    auto reverse_bit = [&](std::size_t b) {
-        std::size_t n = 0;
-        for (std::size_t i = 0; i < BIT_SIZE; i++) {
-            n = n << 1;
-            n = n | (b & 1);
-            b = b >> 1;
-        }
-        return n;
-    };
-
-    // Split the original samples into even and odds part with reverse bit
-    fft_vec fft_samples(N, 0.0);
-    for (std::size_t i = 0; i < N; i++)
-        fft_samples[i] = samples[reverse_bit(i)];
-
-    // Compute the data permutation for the iterative FFT
-    auto const q = BIT_SIZE;
-    for (std::size_t j = 0; j < q; j++) {
-        auto const m     = std::exp2(j);
-        auto const k_lim = std::exp2(q - (j + 1));
-        for (std::size_t k = 0; k < k_lim; k++) {
-            auto const start = k * 2 * m;
-            auto const end   = (k + 1) * 2 * m - 1;
-            auto const mid   = start + (end - start + 1) / 2;
-
-            for (std::size_t n = 0; n < m; n++) {
-                auto const index = n + start;
-                auto const z = std::exp(-1.0i * nrv::pi * f64(n) / f64(m)) * fft_samples[n + mid];
-                auto const f = fft_samples[index];
-
-                fft_samples[index]     = f + z;
-                fft_samples[index + m] = f - z;
-            }
-        }
-    }
-
-    return fft_samples;
-}
+#include "fft.hpp"
+#include "fft_parallel.hpp"
+#include "plan_cache.hpp"
+#include "reference.hpp"
 
 auto complex_to_str_vec(fft_vec const& fft) -> std::vector<std::string> {
     using namespace std::string_literals;
@@ -173,14 +74,170 @@ auto fft_to_csv_str(fft_vec const& fft) -> std::string {
     return csv;
 }
 
+/**
+ * Check the plan against fft_i for every instruction set the CPU supports, in
+ * double and float. The vector kernels fuse the multiply-add and do two stages
+ * per pass, so the results can't be bit exact. The error is measured relative
+ * to the largest bin and has to stay within a few ulp per stage.
+ */
+template <typename T>
+auto check_plan(nrv::simd_isa const& isa, std::size_t const& N, fft_vec const& samples, fft_vec const& expected) -> bool {
+    std::vector<std::complex<T>> data(N);
+    std::transform(std::begin(samples), std::end(samples), std::begin(data),
+                   [](auto const& v) { return std::complex<T>(v); });
+    nrv::fft_plan<T>(N).execute(data);
+
+    f64 max_error = 0.0, max_value = 0.0;
+    for (std::size_t i = 0; i < N; i++) {
+        max_error = std::max(max_error, std::abs(std::complex<f64>(data[i]) - expected[i]));
+        max_value = std::max(max_value, std::abs(expected[i]));
+    }
+    auto const error     = max_value > 0.0 ? max_error / max_value : max_error;
+    auto const stages    = std::max(1.0, std::log2(f64(N)));
+    auto const tolerance = 4.0 * stages * f64(std::numeric_limits<T>::epsilon());
+    auto const ok        = error <= tolerance;
+    fmt::print("{:>6} {:>6} {:>8} {:>10.3e} {:>10.3e} {}\n", nrv::to_string(isa),
+               sizeof(T) == 8 ? "f64" : "f32", N, error, tolerance, ok ? "ok" : "FAIL");
+    return ok;
+}
+
+auto check_simd() -> bool {
+    std::mt19937 rng{0};
+    std::uniform_real_distribution<f64> dist(-1.0, 1.0);
+
+    auto const detected = nrv::simd_detect();
+    auto ok = true;
+    fmt::print("{:>6} {:>6} {:>8} {:>10} {:>10}\n", "isa", "type", "N", "error", "tolerance");
+    for (std::size_t N = 1; N <= (1 << 16); N <<= 1) {
+        fft_vec samples(N);
+        for (auto& v : samples) v = {dist(rng), dist(rng)};
+        auto const expected = fft_i(samples);
+
+        for (auto const isa : {nrv::simd_isa::scalar, nrv::simd_isa::sse2, nrv::simd_isa::avx2, nrv::simd_isa::avx512}) {
+            if (!nrv::simd_select(isa)) continue;
+            ok = check_plan<f64>(isa, N, samples, expected) && ok;
+            ok = check_plan<nrv::f32>(isa, N, samples, expected) && ok;
+        }
+    }
+    nrv::simd_select(detected);
+    return ok;
+}
+
+/**
+ * The parallel transform splits the stages differently, compare it with the
+ * plan on the calling thread for sizes around the serial cutoff and above.
+ */
+auto check_parallel() -> bool {
+    std::mt19937 rng{0};
+    std::uniform_real_distribution<f64> dist(-1.0, 1.0);
+
+    nrv::thread_pool pool{4};
+    auto ok = true;
+    for (auto const N : {std::size_t(1) << 14, std::size_t(1) << 15, std::size_t(1) << 18, std::size_t(1) << 20, std::size_t(100003)}) {
+        fft_vec serial(N);
+        for (auto& v : serial) v = {dist(rng), dist(rng)};
+        auto parallel = serial;
+
+        auto const plan = nrv::fft_plan_cache<f64>::get(N);
+        plan->execute(serial);
+        nrv::execute(*plan, parallel, pool);
+
+        f64 max_error = 0.0, max_value = 0.0;
+        for (std::size_t i = 0; i < N; i++) {
+            max_error = std::max(max_error, std::abs(parallel[i] - serial[i]));
+            max_value = std::max(max_value, std::abs(serial[i]));
+        }
+        auto const error     = max_error / max_value;
+        auto const tolerance = 4.0 * std::log2(f64(N)) * std::numeric_limits<f64>::epsilon();
+        fmt::print("{:>6} {:>6} {:>8} {:>10.3e} {:>10.3e} {}\n", "pool", "f64", N, error, tolerance,
+                   error <= tolerance ? "ok" : "FAIL");
+        ok = error <= tolerance && ok;
+    }
+    return ok;
+}
+
+/**
+ * A batch has to give the same result as transforming every signal on its
+ * own, contiguous (signal b at b * N) and interleaved (value i of signal b
+ * at i * B + b), forward and backward. Small radix-2 signals go through the
+ * lane kernel of every instruction set, which rounds differently, the rest
+ * through the plan. B isn't a multiple of the lanes so the last tile is
+ * partial.
+ */
+template <typename T>
+auto check_batch(nrv::simd_isa const& isa, std::size_t const& N, bool const& interleaved, bool const& backward) -> bool {
+    using complex_type = std::complex<T>;
+    std::mt19937 rng{std::uint32_t(N)};
+    std::uniform_real_distribution<f64> dist(-1.0, 1.0);
+
+    std::size_t const B = 100;
+    auto const stride = interleaved ? B : 1;
+    auto const step   = interleaved ? 1 : N;
+    std::vector<complex_type> batch(N * B);
+    for (auto& v : batch) v = {T(dist(rng)), T(dist(rng))};
+    nrv::fft_plan<T> const plan{N};
+
+    auto expected = batch;
+    std::vector<complex_type> signal(N);
+    for (std::size_t b = 0; b < B; b++) {
+        for (std::size_t i = 0; i < N; i++) signal[i] = expected[b * step + i * stride];
+        if (backward) plan.inverse(signal);
+        else          plan.execute(signal);
+        for (std::size_t i = 0; i < N; i++) expected[b * step + i * stride] = signal[i];
+    }
+    if (backward) nrv::inverse_batch(plan, batch, B, stride, step);
+    else          nrv::execute_batch(plan, batch, B, stride, step);
+
+    f64 max_error = 0.0, max_value = 0.0;
+    for (std::size_t i = 0; i < N * B; i++) {
+        max_error = std::max(max_error, f64(std::abs(batch[i] - expected[i])));
+        max_value = std::max(max_value, f64(std::abs(expected[i])));
+    }
+    auto const error     = max_error / max_value;
+    auto const tolerance = 4.0 * std::max(1.0, std::log2(f64(N))) * f64(std::numeric_limits<T>::epsilon());
+    auto const ok        = error <= tolerance;
+    fmt::print("{:>6} {:>6} {:>8} {:>10.3e} {:>10.3e} {} batch {} {}\n", nrv::to_string(isa),
+               sizeof(T) == 8 ? "f64" : "f32", N, error, tolerance, ok ? "ok" : "FAIL",
+               interleaved ? "interleaved" : "contiguous", backward ? "backward" : "forward");
+    return ok;
+}
+
+auto check_batch() -> bool {
+    auto const detected = nrv::simd_detect();
+    auto ok = true;
+    for (auto const isa : {nrv::simd_isa::scalar, nrv::simd_isa::sse2, nrv::simd_isa::avx2, nrv::simd_isa::avx512}) {
+        if (!nrv::simd_select(isa)) continue;
+        for (auto const N : {std::size_t(1), std::size_t(8), std::size_t(64), std::size_t(1000), std::size_t(1024), std::size_t(4096)}) {
+            for (auto const interleaved : {false, true}) {
+                for (auto const backward : {false, true}) {
+                    ok = check_batch<f64>(isa, N, interleaved, backward) && ok;
+                    ok = check_batch<nrv::f32>(isa, N, interleaved, backward) && ok;
+                }
+            }
+        }
+    }
+    nrv::simd_select(detected);
+    return ok;
+}
+
 auto main([[maybe_unused]]std::int32_t argc, [[maybe_unused]]char const* argv[]) -> std::int32_t {
+    if (argc > 1 && std::string_view(argv[1]) == "check")
+        return check_simd() && check_parallel() && check_batch() ? 0 : 1;
+
     fft_vec const samples{1.0, 1.0, 1.0, 1.0, 0.0, 0.0, 0.0, 0.0};
 
     // FFT recursive
     //fmt::print("{}\n", vec_to_json(complex_to_str_vec(fft_r(samples))));
 
-    // FFT iterative
-    fmt::print("{}\n", fft_to_csv_str(fft_i(samples)));
+    // FFT iterative, the reference the plan is compared with
+    if (argc > 1 && std::string_view(argv[1]) == "reference") {
+        fmt::print("{}\n", fft_to_csv_str(fft_i(samples)));
+        return 0;
+    }
+
+    // FFT iterative with a cached plan, same result as fft_i
+    auto const plan = nrv::fft_plan_cache<f64>::get(samples.size());
+    fmt::print("{}\n", fft_to_csv_str((*plan)(samples)));
 
     return 0;
 }
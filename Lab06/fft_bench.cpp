@@ -0,0 +1,256 @@
+/**
+ * @file   fft_bench.cpp
+ * @author Pratchaya Khansomboon (pratchaya.k.git@gmail.com)
+ * @brief  Benchmark of the DFT, fft_r and fft_i against the plans of
+ *         Pulse/src/fft.hpp, for float and double over N = 8 to 2^22.
+ * @date   2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+#include <cstdint>
+#include <cstddef>
+#include <cstdlib>
+#include <cmath>
+
+#include <array>
+#include <atomic>
+#include <complex>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "fft.hpp"
+#include "rfft.hpp"
+#include "fft_parallel.hpp"
+#include "reference.hpp"
+
+// Every allocation of the process is counted, the counter of a benchmark is
+// the difference over its timing loop divided by the iterations. Not inlined,
+// GCC would otherwise see free() paired with a new-expression.
+namespace env {
+std::atomic<std::size_t> allocations{0};
+}
+
+[[gnu::noinline]] auto operator new(std::size_t size) -> void* {
+    env::allocations.fetch_add(1, std::memory_order_relaxed);
+    if (auto* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc{};
+}
+[[gnu::noinline]] auto operator new[](std::size_t size) -> void* { return operator new(size); }
+[[gnu::noinline]] auto operator delete(void* p) noexcept -> void { std::free(p); }
+[[gnu::noinline]] auto operator delete[](void* p) noexcept -> void { std::free(p); }
+[[gnu::noinline]] auto operator delete(void* p, std::size_t) noexcept -> void { std::free(p); }
+[[gnu::noinline]] auto operator delete[](void* p, std::size_t) noexcept -> void { std::free(p); }
+
+namespace env {
+constexpr std::size_t min_size  = 8;
+constexpr std::size_t max_size  = std::size_t{1} << 22;
+constexpr std::size_t dft_limit = std::size_t{1} << 12;  // O(N^2) above is minutes
+constexpr std::size_t batch_count = 64;
+// Threads of the pools the parallel transform runs on
+constexpr std::array<std::size_t, 5> pool_sizes{1, 2, 4, 8, 16};
+
+template <typename T>
+auto make_samples(std::size_t const& size) -> complex_vec<T> {
+    complex_vec<T> samples(size);
+    for (std::size_t i = 0; i < size; i++)
+        samples[i] = {T(std::sin(0.1 * f64(i))), T(std::cos(0.37 * f64(i)))};
+    return samples;
+}
+
+template <typename T>
+constexpr auto type_name() -> char const* { return sizeof(T) == 4 ? "f32" : "f64"; }
+
+/**
+ * Counters of a benchmark doing `transforms` complex transforms of size N per
+ * iteration. MFLOPS is the usual 5 N log2(N) per transform, the convention of
+ * benchFFT, also for sizes that aren't a power of 2 so the numbers compare as
+ * a rate of transforms. Real transforms count half of it.
+ */
+auto counters(benchmark::State& state, std::size_t const& N, std::size_t const& allocations,
+              f64 const& transforms = 1.0, f64 const& flop_scale = 1.0) -> void {
+    auto const flops = flop_scale * 5.0 * f64(N) * std::log2(f64(N)) * transforms;
+    state.counters["MFLOPS"] = benchmark::Counter(flops / 1e6, benchmark::Counter::kIsIterationInvariantRate);
+    // Seconds per transform, printed with an SI prefix (2u is 2 us)
+    state.counters["time/transform"] = benchmark::Counter(transforms,
+        benchmark::Counter::kIsIterationInvariantRate | benchmark::Counter::kInvert);
+    state.counters["allocs"] = benchmark::Counter(f64(allocations), benchmark::Counter::kAvgIterations);
+    state.SetItemsProcessed(state.iterations() * std::int64_t(transforms));
+}
+
+// Run the timing loop of body and set the counters
+template <typename F>
+auto measure(benchmark::State& state, std::size_t const& N, F&& body,
+             f64 const& transforms = 1.0, f64 const& flop_scale = 1.0) -> void {
+    auto const before = allocations.load(std::memory_order_relaxed);
+    for (auto _ : state) {
+        body();
+        benchmark::ClobberMemory();
+    }
+    auto const after = allocations.load(std::memory_order_relaxed);
+    counters(state, N, after - before, transforms, flop_scale);
+}
+
+auto sizes(std::size_t const& limit) -> std::vector<std::int64_t> {
+    std::vector<std::int64_t> out{};
+    for (auto N = min_size; N <= limit; N *= 4) out.push_back(std::int64_t(N));
+    if (out.back() != std::int64_t(limit)) out.push_back(std::int64_t(limit));
+    return out;
+}
+
+template <typename F>
+auto add(std::string const& name, std::vector<std::int64_t> const& args, F&& fn) -> void {
+    auto* b = benchmark::RegisterBenchmark(name.c_str(), std::forward<F>(fn));
+    for (auto const& N : args) b->Arg(N);
+    b->Unit(benchmark::kMicrosecond);
+}
+
+// First size from N up that the plan computes with Bluestein's algorithm
+template <typename T>
+auto bluestein_size(std::size_t N) -> std::size_t {
+    while (nrv::fft_plan<T>(N).algorithm() != nrv::fft_algorithm::bluestein) N++;
+    return N;
+}
+}  // namespace env
+
+template <typename T>
+auto register_type(std::vector<std::unique_ptr<nrv::thread_pool>> const& pools) -> void {
+    using complex_type = std::complex<T>;
+    auto const type = std::string(env::type_name<T>());
+
+    env::add("dft<" + type + ">", env::sizes(env::dft_limit), [](benchmark::State& state) {
+        auto const N = std::size_t(state.range(0));
+        auto const samples = env::make_samples<T>(N);
+        env::measure(state, N, [&] { benchmark::DoNotOptimize(dft(samples)); });
+    });
+    env::add("fft_r<" + type + ">", env::sizes(env::max_size), [](benchmark::State& state) {
+        auto const N = std::size_t(state.range(0));
+        auto const samples = env::make_samples<T>(N);
+        env::measure(state, N, [&] { benchmark::DoNotOptimize(fft_r(samples)); });
+    });
+    env::add("fft_i<" + type + ">", env::sizes(env::max_size), [](benchmark::State& state) {
+        auto const N = std::size_t(state.range(0));
+        auto const samples = env::make_samples<T>(N);
+        env::measure(state, N, [&] { benchmark::DoNotOptimize(fft_i(samples)); });
+    });
+
+    // The plan with every instruction set the CPU has
+    for (auto const isa : {nrv::simd_isa::scalar, nrv::simd_isa::sse2, nrv::simd_isa::avx2, nrv::simd_isa::avx512}) {
+        if (!nrv::simd_supported(isa)) continue;
+        env::add("fft_plan<" + type + ">/" + nrv::to_string(isa), env::sizes(env::max_size),
+            [isa](benchmark::State& state) {
+                auto const N = std::size_t(state.range(0));
+                auto const active = nrv::simd_active();
+                nrv::simd_select(isa);
+                nrv::fft_plan<T> const plan{N};
+                auto data = env::make_samples<T>(N);
+                env::measure(state, N, [&] { plan.execute(std::span(data)); });
+                nrv::simd_select(active);
+            });
+    }
+
+    env::add("fft_plan<" + type + ">/out_of_place", env::sizes(env::max_size), [](benchmark::State& state) {
+        auto const N = std::size_t(state.range(0));
+        nrv::fft_plan<T> const plan{N};
+        auto const in = env::make_samples<T>(N);
+        complex_vec<T> out(N);
+        env::measure(state, N, [&] { plan.execute(std::span(in), std::span(out)); });
+    });
+
+    // 3 * 2^k, the mixed radix path
+    std::vector<std::int64_t> mixed{};
+    for (auto const& N : env::sizes(env::max_size / 4)) mixed.push_back(3 * N);
+    env::add("fft_plan<" + type + ">/mixed_radix", mixed, [](benchmark::State& state) {
+        auto const N = std::size_t(state.range(0));
+        nrv::fft_plan<T> const plan{N};
+        auto data = env::make_samples<T>(N);
+        std::vector<complex_type> scratch(plan.scratch_size());
+        env::measure(state, N, [&] { plan.execute(std::span(data), std::span(data), std::span(scratch)); });
+    });
+
+    std::vector<std::int64_t> bluestein{};
+    for (auto const& N : env::sizes(env::max_size / 4))
+        bluestein.push_back(std::int64_t(env::bluestein_size<T>(std::size_t(N))));
+    env::add("fft_plan<" + type + ">/bluestein", bluestein, [](benchmark::State& state) {
+        auto const N = std::size_t(state.range(0));
+        nrv::fft_plan<T> const plan{N};
+        auto data = env::make_samples<T>(N);
+        std::vector<complex_type> scratch(plan.scratch_size());
+        env::measure(state, N, [&] { plan.execute(std::span(data), std::span(data), std::span(scratch)); });
+    });
+
+    env::add("rfft_plan<" + type + ">", env::sizes(env::max_size), [](benchmark::State& state) {
+        auto const N = std::size_t(state.range(0));
+        nrv::rfft_plan<T> const plan{N};
+        std::vector<T> in(N);
+        for (std::size_t i = 0; i < N; i++) in[i] = T(std::sin(0.1 * f64(i)));
+        std::vector<complex_type> out(plan.bins());
+        std::vector<complex_type> scratch(plan.scratch_size());
+        env::measure(state, N, [&] { plan.execute(std::span(std::as_const(in)), std::span(out), std::span(scratch)); },
+                     1.0, 0.5);
+    });
+
+    // Every pool size over the power of 2 sizes from the cutoff up, the
+    // speed-up is the time at threads:1 over the time at threads:n
+    std::vector<std::int64_t> large{};
+    for (auto N = nrv::fft_parallel_cutoff; N <= env::max_size; N *= 2) large.push_back(std::int64_t(N));
+    for (auto const& pool : pools) {
+        env::add("fft_plan<" + type + ">/threads:" + std::to_string(pool->size()), large,
+            [&pool = *pool](benchmark::State& state) {
+                auto const N = std::size_t(state.range(0));
+                nrv::fft_plan<T> const plan{N};
+                auto data = env::make_samples<T>(N);
+                env::measure(state, N, [&] { nrv::execute(plan, std::span(data), pool); });
+            });
+    }
+
+    // The parallel radix-2 path without the cutoff, below and around it.
+    // Against threads:1 it's the cost of waking the pool, which the cutoff
+    // has to be well above.
+    std::vector<std::int64_t> small{};
+    for (auto N = nrv::fft_parallel_block; N <= 4 * nrv::fft_parallel_cutoff; N *= 2) small.push_back(std::int64_t(N));
+    for (auto const& pool : pools) {
+        env::add("fft_parallel<" + type + ">/threads:" + std::to_string(pool->size()), small,
+            [&pool = *pool](benchmark::State& state) {
+                using parallel = nrv::detail::fft_parallel<T>;
+                auto const N = std::size_t(state.range(0));
+                nrv::fft_plan<T> const plan{N};
+                auto data = env::make_samples<T>(N);
+                env::measure(state, N, [&] {
+                    parallel::radix2_permute(std::span(data), pool);
+                    parallel::radix2_butterflies(plan, data.data(), pool);
+                });
+            });
+    }
+
+    // batch_count signals of N, contiguous and interleaved
+    env::add("fft_plan<" + type + ">/batch", env::sizes(env::max_size / env::batch_count), [](benchmark::State& state) {
+        auto const N = std::size_t(state.range(0));
+        nrv::fft_plan<T> const plan{N};
+        auto data = env::make_samples<T>(N * env::batch_count);
+        env::measure(state, N, [&] { nrv::execute_batch(plan, std::span(data)); }, f64(env::batch_count));
+    });
+    env::add("fft_plan<" + type + ">/batch_interleaved", env::sizes(env::max_size / env::batch_count),
+        [](benchmark::State& state) {
+            auto const N = std::size_t(state.range(0));
+            nrv::fft_plan<T> const plan{N};
+            auto data = env::make_samples<T>(N * env::batch_count);
+            env::measure(state, N, [&] { nrv::execute_batch(plan, std::span(data), env::batch_count, env::batch_count, 1); },
+                         f64(env::batch_count));
+        });
+}
+
+auto main(int argc, char** argv) -> int {
+    std::vector<std::unique_ptr<nrv::thread_pool>> pools{};
+    for (auto const& threads : env::pool_sizes) pools.push_back(std::make_unique<nrv::thread_pool>(threads));
+    register_type<nrv::f32>(pools);
+    register_type<f64>(pools);
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
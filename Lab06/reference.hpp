@@ -0,0 +1,147 @@
+/**
+ * @file   reference.hpp
+ * @author Pratchaya Khansomboon (pratchaya.k.git@gmail.com)
+ * @brief  Reference transforms of Lab06, the DFT and the recursive and
+ *         iterative FFT, shared by fft.cpp and the benchmark.
+ * @date   2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+
+#include <complex>
+#include <numbers>
+#include <vector>
+
+using f64 = double;
+template <typename T>
+using complex_vec = std::vector<std::complex<T>>;
+using fft_type = std::complex<f64>;
+using fft_vec  = complex_vec<f64>;
+
+namespace nrv {
+    [[maybe_unused]]inline constexpr auto pi = std::numbers::pi;
+}
+
+/**
+ * DFT straight from the definition, every bin is the sum over all samples
+ * rotated by e^(-2*pi*i*k*n/N) with a cos/sin per term, like dft() in Lab05.
+ * The complexity is O(N^2). The sum is kept in double for both types.
+ */
+template <typename T>
+auto dft(complex_vec<T> const& samples) -> complex_vec<T> {
+    auto const N = samples.size();
+    complex_vec<T> bins(N);
+    for (std::size_t k = 0; k < N; k++) {
+        std::complex<f64> sum{};
+        for (std::size_t n = 0; n < N; n++) {
+            auto const angle = -2.0 * nrv::pi * f64((k * n) % N) / f64(N);
+            sum += std::complex<f64>(samples[n]) * std::complex<f64>{std::cos(angle), std::sin(angle)};
+        }
+        bins[k] = std::complex<T>(sum);
+    }
+    return bins;
+}
+
+/**
+ * FFT recursive algorithm uses the classic divide and conquer algorithm. Which
+ * makes it a straight forward to implement. With complexity O(N * log_2(N)).
+ * However, the space complexity of this implementation is very good, the
+ * function is called twice in every recursion and in total an array of length
+ * 2^n has to be stored n times. This leads to space complexity of O(2^n * n).
+ */
+template <typename T>
+auto fft_r(complex_vec<T> const& samples) -> complex_vec<T> {
+    using namespace std::complex_literals;
+    auto const N = samples.size();
+    if (N == 1) return samples;
+
+    // Split by the middle
+    auto const m = N / 2;
+
+    // Generate 'Even' and 'Odd' list of complex numbers with
+    // the size half of the sample size.
+    complex_vec<T> x_e(m, T(0));  // Even samples
+    complex_vec<T> x_o(m, T(0));  // Odd samples
+    // Split the samples for the 'Even' and 'Odd' DFT
+    for (std::size_t i = 0; i < m; i++) {
+        x_e[i] = samples[2 * i];      // Even: x_{2m}
+        x_o[i] = samples[2 * i + 1];  // Odd:  x_{2m + 1}
+    }
+
+    // Recursively split the rest of Evens and Odds
+    complex_vec<T> const f_e = fft_r(x_e);
+    complex_vec<T> const f_o = fft_r(x_o);
+
+    // Compute the DFT
+    complex_vec<T> res(N, T(0));
+    for (std::size_t k = 0; k < m; k++) {
+        auto const c = std::complex<T>(std::exp(-2.0i * nrv::pi * f64(k) / f64(N))) * f_o[k];
+
+        res[k]     = f_e[k] + c;
+        res[k + m] = f_e[k] - c;
+    }
+
+    return res;
+}
+
+/**
+ * FFT iterative algorithm is not as straight forward as the recursive. The data
+ * is divided into two arrays. The first one contains all even and the second
+ * one all odd indices. If apply again to the subproblems, there are four arrays.
+ * This is the FFT algorithm. For sample count of N = 8, the permutation is
+ * log_2(N) = 3. The method is constructed for arbitrary N = 2^n.
+ *
+ * The rearrange in the manner that'll solve the problem can be done with
+ * 'bit inversion'/'reverse bit'. This means that the index k is written in
+ * binary representation and then read backwards.
+ */
+template <typename T>
+auto fft_i(complex_vec<T> const& samples) -> complex_vec<T> {
+    using namespace std::complex_literals;
+    auto const N = samples.size();
+
+    // Reverse the bits, N = 2^n
+    // This is call radix-2 algorithm.
+    auto const BIT_SIZE = std::log(N) / std::log(2);
+    auto reverse_bit = [&](std::size_t b) {
+        std::size_t n = 0;
+        for (std::size_t i = 0; i < BIT_SIZE; i++) {
+            n = n << 1;
+            n = n | (b & 1);
+            b = b >> 1;
+        }
+        return n;
+    };
+
+    // Split the original samples into even and odds part with reverse bit
+    complex_vec<T> fft_samples(N, T(0));
+    for (std::size_t i = 0; i < N; i++)
+        fft_samples[i] = samples[reverse_bit(i)];
+
+    // Compute the data permutation for the iterative FFT
+    auto const q = BIT_SIZE;
+    for (std::size_t j = 0; j < q; j++) {
+        auto const m     = std::exp2(j);
+        auto const k_lim = std::exp2(q - (j + 1));
+        for (std::size_t k = 0; k < k_lim; k++) {
+            auto const start = k * 2 * m;
+            auto const end   = (k + 1) * 2 * m - 1;
+            auto const mid   = start + (end - start + 1) / 2;
+
+            for (std::size_t n = 0; n < m; n++) {
+                auto const index = n + start;
+                auto const z = std::complex<T>(std::exp(-1.0i * nrv::pi * f64(n) / f64(m))) * fft_samples[n + mid];
+                auto const f = fft_samples[index];
+
+                fft_samples[index]     = f + z;
+                fft_samples[index + m] = f - z;
+            }
+        }
+    }
+
+    return fft_samples;
+}
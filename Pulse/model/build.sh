@@ -20,5 +20,5 @@ mkdir -p ${bin}
 mkdir -p ${obj}
 
 # compile
-c++ ${compile_flags} ${in} -o ${bin}/${out}
+c++ ${compile_flags} ${CXXFLAGS} ${in} -o ${bin}/${out}
 
@@ -18,7 +18,7 @@
 #include <random>
 
 #include "types.hpp"
-#include "ring.hpp"
+#include "sos.hpp"
 
 namespace env {
 auto clear = "\033[H\033[2J";
@@ -26,19 +26,17 @@ auto hide  = "\033[?25l";
 auto show  = "\033[?25h";
 auto reset = "\u001b[0m";
 
-nrv::f64 a[] = {
-1,-6.70218347938014,24.2633638293347,-59.0054321458422,106.180528967321,-147.266003327997,161.009487809362,-139.436308280412,95.1865660901505,-50.0780390785878,19.4940629397266,-5.09719247659637,0.720189367854421
+// 12th order, [sos, g] = tf2sos(b, a) of the direct form polynomials
+// whose a[] had coefficients up to 161, rows [b0 b1 b2 a0 a1 a2]
+nrv::f64 sos[6][6] = {
+    {1,  0.3399831681447651, 1, 1, -1.018766881482488, 0.9036296575269372},
+    {1, -1.813082018520432,  1, 1, -1.200787501656151, 0.9109152870819892},
+    {1, -0.5842450367274924, 1, 1, -0.8922504589261858, 0.9440200883842239},
+    {1, -1.551985601255788,  1, 1, -1.340110394284649, 0.9539132729586015},
+    {1, -0.7168898809789509, 1, 1, -0.8452634360601738, 0.9839608554588707},
+    {1, -1.489447966526394,  1, 1, -1.40500480695129,  0.987439030829013},
 };
-nrv::f64 b[] = {
-0.00148036694850925,-0.00860932170753858,0.0273399672684535,-0.0600063877173575,0.100704056886858,-0.135176869970052,0.148805416797188,-0.135176869970052,0.100704056886859,-0.0600063877173578,0.0273399672684536,-0.00860932170753864,0.00148036694850926
-};
-
-template <typename T, std::size_t N>
-constexpr auto length_of(T (&)[N]) -> std::size_t {
-    return N;
-}
-
-using ring_t = nrv::ring<nrv::f64, length_of(b)>;
+nrv::f64 g[] = {0.00148036694850925};
 
 auto ecg(nrv::f64 x) -> nrv::f64 {
     auto f = 1.5;
@@ -50,24 +48,7 @@ auto test(nrv::f64 x) -> nrv::f64 {
     return std::sin(2.0 * M_PI * 150.0 * x);
 }
 
-static nrv::ring<nrv::f64, length_of(b)> x_r{};
-static nrv::ring<nrv::f64, length_of(a)> y_r{};
-
-auto iir(nrv::f64 const& value) -> nrv::f64 {
-    x_r.enq(value);
-
-    auto forward = 0.0;
-    for (std::size_t i = 0; i < x_r.capacity(); i++) {
-        forward += b[i] * x_r[i];
-    }
-
-    auto feedback = 0.0;
-    for (std::size_t i = 1; i < y_r.capacity(); i++) {
-        feedback += -a[i] * y_r[i - 1];
-    }
-    y_r.enq(forward + feedback);
-    return *y_r.rbegin();
-}
+static nrv::sos<nrv::f64, 6> filter{sos, g};
 
 }  // namespace env
 
@@ -99,16 +80,11 @@ auto main([[maybe_unused]]nrv::i32 argc, [[maybe_unused]]char const* argv[]) ->
         return env::test(Ts * n) + noise(n);
     });
 
-    // Direct Form II IIR System Second Order Sections
+    // Transposed Direct Form II IIR System Second Order Sections
 
     std::vector<nrv::f64> output(sample_count);
-    //env::ring_t w{};
 
-    for (nrv::usize i = 0; i < sample_count; i++) {
-        auto read_value = samples_noise[i];
-        output[i] = env::iir(read_value);
-        //std::cout << output[i] << "\n";
-    }
+    env::filter.process(samples_noise, output);
 
     std::ofstream plot_data{"plot_data.csv"};
     plot_data << "samples" << "," << "original" << "," << "w/ noise" << "," << "filtered" << "\n";
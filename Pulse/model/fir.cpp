@@ -0,0 +1,116 @@
+/**
+ * @file   fir.cpp
+ * @author Pratchaya Khansomboon (pratchaya.k.git@gmail.com)
+ * @brief  FIR engine against the direct form convolution, the 29 taps of
+ *         Lab04 and long low-pass filters that run partitioned. The times
+ *         are only meaningful optimised: CXXFLAGS=-O2 ./build.sh fir.cpp
+ * @date   2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+#include <iostream>
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <random>
+
+#include "types.hpp"
+#include "fir.hpp"
+
+namespace env {
+// Lab04/src/main.cpp
+std::array<nrv::f32, 29> lab04_b{
+    0.01080096047f,   0.009150882252f,  0.007511904463f,  0.0005792030715f, -0.01127376128f,
+    -0.02515191026f,  -0.03590095788f,  -0.03739762306f,  -0.02453046478f,    0.004719638731f,
+     0.04788555577f,   0.09797523171f,   0.1449637711f,    0.1784338504f,     0.1905580908f,
+     0.1784338504f,    0.1449637711f,    0.09797523171f,   0.04788555577f,    0.004719638731f,
+    -0.02453046478f,  -0.03739762306f,  -0.03590095788f,  -0.02515191026f,   -0.01127376128f,
+     0.0005792030715f, 0.007511904463f,  0.009150882252f,  0.01080096047f
+};
+
+template <typename T>
+auto direct(std::vector<T> const& b, std::vector<T> const& x) -> std::vector<T> {
+    std::vector<T> y(x.size());
+    for (nrv::usize n = 0; n < x.size(); n++) {
+        nrv::f64 sum = 0.0;
+        for (nrv::usize k = 0; k < b.size() && k <= n; k++) sum += nrv::f64(b[k]) * nrv::f64(x[n - k]);
+        y[n] = T(sum);
+    }
+    return y;
+}
+
+template <typename F>
+auto time_ns(F&& f) -> nrv::f64 {
+    auto const start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<nrv::f64, std::nano>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * Stream x through the engine in blocks of random size and compare with the
+ * direct convolution, then time the engine per sample against the direct form
+ * and the partitioned form of the same filter, best of 5. The engine should be
+ * about the faster of the two, that's what fir::default_direct_limit is for.
+ */
+template <typename T>
+auto run(char const* name, std::vector<T> const& b, std::vector<T> const& x) -> bool {
+    auto const expected = direct(b, x);
+
+    nrv::fir<T> filter{b};
+    std::vector<T> y(x.size());
+    std::mt19937 rng{1};
+    std::uniform_int_distribution<nrv::usize> block(1, 300);
+    for (nrv::usize i = 0; i < x.size();) {
+        auto const n = std::min(block(rng), x.size() - i);
+        filter.process(std::span(x).subspan(i, n), std::span(y).subspan(i, n));
+        i += n;
+    }
+
+    nrv::f64 max_error = 0.0;
+    for (nrv::usize i = 0; i < x.size(); i++)
+        max_error = std::max(max_error, std::abs(nrv::f64(y[i]) - nrv::f64(expected[i])));
+
+    nrv::fir<T> reference{b, b.size()};  // one partition, the direct form only
+    nrv::fir<T> partitioned{b, 0, 0};    // the partitioned form at any length
+    auto const per_sample = [&](nrv::fir<T>& f) {
+        nrv::f64 best = 1e300;
+        for (nrv::usize repeat = 0; repeat < 5; repeat++) {
+            f.reset();
+            best = std::min(best, time_ns([&] { f.process(x, y); }));
+        }
+        return best / nrv::f64(x.size());
+    };
+    auto const engine_ns = per_sample(filter);
+    auto const direct_ns = per_sample(reference);
+    auto const partitioned_ns = per_sample(partitioned);
+
+    auto const tolerance = sizeof(T) == 4 ? 1e-4 : 1e-10;
+    auto const ok = max_error < tolerance;
+    std::cout << name << ": " << b.size() << " taps, partition " << filter.partition()
+              << " x " << filter.partitions() << ", max error " << max_error
+              << ", " << engine_ns << " ns/sample (direct form " << direct_ns << ", partitioned "
+              << partitioned_ns << " ns/sample) "
+              << (ok ? "ok" : "FAIL") << "\n";
+    return ok;
+}
+}  // namespace env
+
+auto main([[maybe_unused]]nrv::i32 argc, [[maybe_unused]]char const* argv[]) -> nrv::i32 {
+    constexpr nrv::usize sample_count = 1 << 16;
+    std::mt19937 rng{0};
+    std::uniform_real_distribution<nrv::f64> noise(-1.0, 1.0);
+    std::vector<nrv::f64> x(sample_count);
+    for (auto& v : x) v = noise(rng);
+    std::vector<nrv::f32> x32(std::begin(x), std::end(x));
+
+    auto ok = true;
+    ok = env::run("Lab04", std::vector<nrv::f32>(std::begin(env::lab04_b), std::end(env::lab04_b)), x32) && ok;
+    for (auto const taps : {65, 96, 128, 255, 1023, 4095}) {
+        ok = env::run("low-pass f64", nrv::make_lowpass<nrv::f64>(nrv::usize(taps), 0.05), x) && ok;
+        ok = env::run("low-pass f32", nrv::make_lowpass<nrv::f32>(nrv::usize(taps), 0.05), x32) && ok;
+    }
+    return ok ? 0 : 1;
+}
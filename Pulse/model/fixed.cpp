@@ -0,0 +1,194 @@
+/**
+ * @file   fixed.cpp
+ * @author Pratchaya Khansomboon (pratchaya.k.git@gmail.com)
+ * @brief  The q15 and q31 FIR, SOS and block floating point FFT kernels
+ *         against the floating point reference.
+ * @date   2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+#include <iostream>
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <complex>
+#include <random>
+#include <string>
+
+#include "types.hpp"
+#include "fixed.hpp"
+#include "fft.hpp"
+#include "sos.hpp"
+#include "pulse_filters.hpp"
+
+namespace env {
+constexpr nrv::usize sample_count = 20'000;
+
+// Lab04 low-pass at 10 kHz
+nrv::f64 lab04[] = {
+    0.01080096047,   0.009150882252,  0.007511904463,  0.0005792030715, -0.01127376128,
+    -0.02515191026,  -0.03590095788,  -0.03739762306,  -0.02453046478,    0.004719638731,
+     0.04788555577,   0.09797523171,   0.1449637711,    0.1784338504,     0.1905580908,
+     0.1784338504,    0.1449637711,    0.09797523171,   0.04788555577,    0.004719638731,
+    -0.02453046478,  -0.03739762306,  -0.03590095788,  -0.02515191026,   -0.01127376128,
+     0.0005792030715, 0.007511904463,  0.009150882252,  0.01080096047
+};
+
+// 12-bit ADC readings of a signal and noise scaled to [-1, 1), the values
+// the kernels see. The offset of the pulse sensor is kept when dc is set.
+auto adc(nrv::f64 const& fs, nrv::f64 const& f, bool const& dc) -> std::vector<nrv::f64> {
+    std::mt19937 rng{0};
+    std::normal_distribution<nrv::f64> noise(0.0, 0.02);
+    std::vector<nrv::f64> x(sample_count);
+    for (nrv::usize n = 0; n < sample_count; n++) {
+        auto const t = nrv::f64(n) / fs;
+        auto const v = (dc ? 0.45 : 0.0) + 0.3 * std::sin(2.0 * M_PI * f * t) + 0.1 * std::cos(2.0 * M_PI * 0.05 * t)
+                     + noise(rng);
+        x[n] = std::round(std::clamp(v, -1.0, 1.0) * 2048.0) / 2048.0;
+    }
+    return x;
+}
+
+// Signal to noise ratio of out against reference in dB, from sample skip
+auto snr(std::vector<nrv::f64> const& reference, std::vector<nrv::f64> const& out, nrv::usize const& skip = 0) {
+    nrv::f64 signal = 0.0, noise = 0.0;
+    for (nrv::usize i = skip; i < reference.size(); i++) {
+        signal += reference[i] * reference[i];
+        noise  += (out[i] - reference[i]) * (out[i] - reference[i]);
+    }
+    return 10.0 * std::log10(signal / std::max(noise, 1e-300));
+}
+
+auto report(char const* name, nrv::f64 const& value, nrv::f64 const& minimum) -> bool {
+    auto const ok = value >= minimum;
+    std::cout << name << ": SNR " << value << " dB, at least " << minimum << " " << (ok ? "ok" : "FAIL") << "\n";
+    return ok;
+}
+
+// Filter x as Q with filter and convert back
+template <typename Q, typename Filter>
+auto run(Filter& filter, std::vector<nrv::f64> const& x) -> std::vector<nrv::f64> {
+    auto const in = nrv::to_fixed<Q>(x);
+    std::vector<Q> out(in.size());
+    filter.process(in, out);
+    std::vector<nrv::f64> y(out.size());
+    std::transform(std::begin(out), std::end(out), std::begin(y), [](Q const& v) { return v.to(); });
+    return y;
+}
+
+// 4th order Butterworth low-pass from two RBJ biquads
+auto butterworth(nrv::f64 const& fc, nrv::f64 const& fs) -> nrv::sos<nrv::f64, 2> {
+    nrv::f64 matrix[2][6]{};
+    nrv::f64 const q[] = {0.5411961001461970, 1.3065629648763766};
+    auto const w = 2.0 * M_PI * fc / fs;
+    for (nrv::usize i = 0; i < 2; i++) {
+        auto const alpha = std::sin(w) / (2.0 * q[i]);
+        auto const c = std::cos(w);
+        nrv::f64 const row[] = {(1.0 - c) / 2.0, 1.0 - c, (1.0 - c) / 2.0, 1.0 + alpha, -2.0 * c, 1.0 - alpha};
+        std::copy(std::begin(row), std::end(row), std::begin(matrix[i]));
+    }
+    return nrv::sos<nrv::f64, 2>{matrix, {1.0}};
+}
+
+/**
+ * The design against the fixed point filter, once with and once without
+ * error feedback. The SNR against the design includes the error of the
+ * quantised coefficients, against the same coefficients in double only the
+ * rounding noise of the arithmetic remains.
+ */
+template <typename Q, nrv::usize N>
+auto sos(char const* name, nrv::sos<nrv::f64, N> const& design, std::vector<nrv::f64> const& x,
+         nrv::f64 const& minimum) -> bool {
+    auto ok = true;
+    for (auto const error_feedback : {false, true}) {
+        nrv::fixed_sos<Q, N> filter{design, error_feedback};
+        auto const y = run<Q>(filter, x);
+
+        std::vector<nrv::f64> reference(x.size()), quantised(x.size());
+        auto reference_filter = design;
+        reference_filter.process(x, reference);
+        nrv::sos<nrv::f64, N> quantised_filter{filter.sections()};
+        quantised_filter.process(x, quantised);
+
+        auto const total = snr(reference, y, sample_count / 2);
+        auto const rounding = snr(quantised, y, sample_count / 2);
+        auto const good = total >= minimum;
+        std::cout << name << (error_feedback ? " error feedback" : "") << ": SNR " << total
+                  << " dB, rounding only " << rounding << " dB, at least " << minimum << " "
+                  << (good ? "ok" : "FAIL") << "\n";
+        ok = ok && good;
+    }
+    return ok;
+}
+
+template <typename Q>
+auto fft(char const* name, nrv::usize const& size, nrv::f64 const& minimum) -> bool {
+    std::mt19937 rng{nrv::u32(size)};
+    std::uniform_real_distribution<nrv::f64> dist(-0.5, 0.5);
+    std::vector<std::complex<nrv::f64>> reference(size);
+    std::vector<nrv::fixed_complex<Q>> data(size);
+    for (nrv::usize i = 0; i < size; i++) {
+        data[i] = {Q::from(dist(rng)), Q::from(dist(rng))};
+        reference[i] = {data[i].re.to(), data[i].im.to()};
+    }
+    nrv::fft_plan<nrv::f64>{size}.execute(reference);
+    auto const exponent = nrv::fixed_fft<Q>{size}.execute(data);
+
+    std::vector<nrv::f64> expected{}, out{};
+    for (nrv::usize i = 0; i < size; i++) {
+        expected.insert(std::end(expected), {reference[i].real(), reference[i].imag()});
+        out.insert(std::end(out), {std::ldexp(data[i].re.to(), exponent), std::ldexp(data[i].im.to(), exponent)});
+    }
+    std::string const label = std::string(name) + " " + std::to_string(size) + ", exponent " + std::to_string(exponent);
+    return report(label.c_str(), snr(expected, out), minimum);
+}
+}  // namespace env
+
+auto main([[maybe_unused]]nrv::i32 argc, [[maybe_unused]]char const* argv[]) -> nrv::i32 {
+    auto ok = true;
+
+    // Saturation instead of wrap around
+    auto const half = nrv::q15::from(0.5);
+    auto const minus_one = nrv::q15::from(-1.0);
+    ok = ok && (half * half).raw == nrv::q15::from(0.25).raw;
+    ok = ok && (minus_one * minus_one).raw == nrv::i16(INT16_MAX);
+    ok = ok && (half + half + half).raw == nrv::i16(INT16_MAX);
+    ok = ok && (-minus_one).raw == nrv::i16(INT16_MAX);
+    ok = ok && (nrv::q31::from(-0.75) - nrv::q31::from(0.75)).raw == nrv::i32(INT32_MIN);
+    std::cout << "saturating q15 and q31 arithmetic " << (ok ? "ok" : "FAIL") << "\n";
+
+    // FIR, the Lab04 low-pass at 10 kHz
+    {
+        auto const x = env::adc(10'000.0, 500.0, false);
+        std::vector<nrv::f64> reference(x.size());
+        for (nrv::usize n = 0; n < x.size(); n++) {
+            nrv::f64 y = 0.0;
+            for (nrv::usize k = 0; k < std::size(env::lab04) && k <= n; k++) y += env::lab04[k] * x[n - k];
+            reference[n] = y;
+        }
+        nrv::fixed_fir<nrv::q15> fir15{nrv::to_fixed<nrv::q15>(env::lab04)};
+        nrv::fixed_fir<nrv::q31> fir31{nrv::to_fixed<nrv::q31>(env::lab04)};
+        ok = env::report("fir q15 29 taps", env::snr(reference, env::run<nrv::q15>(fir15, x)), 70.0) && ok;
+        ok = env::report("fir q31 29 taps", env::snr(reference, env::run<nrv::q31>(fir31, x)), 140.0) && ok;
+    }
+
+    // SOS, a 50 Hz low-pass and the Pulse band-pass at 1 kHz
+    {
+        auto const x = env::adc(1'000.0, 10.0, false);
+        ok = env::sos<nrv::q15>("sos q15 4th order 50 Hz", env::butterworth(50.0, 1'000.0), x, 60.0) && ok;
+        ok = env::sos<nrv::q31>("sos q31 4th order 50 Hz", env::butterworth(50.0, 1'000.0), x, 140.0) && ok;
+
+        auto const pulse = env::adc(1'000.0, 1.2, true);
+        auto const band_pass = nrv::cascade(nrv::sos<nrv::f64, 3>{nrv::high_pass_sos, nrv::high_pass_gain},
+                                            nrv::sos<nrv::f64, 3>{nrv::low_pass_sos, nrv::low_pass_gain});
+        ok = env::sos<nrv::q31>("sos q31 Pulse band-pass", band_pass, pulse, 80.0) && ok;
+    }
+
+    // Block floating point FFT
+    ok = env::fft<nrv::q15>("fft q15", 256, 60.0) && ok;
+    ok = env::fft<nrv::q15>("fft q15", 4096, 55.0) && ok;
+    ok = env::fft<nrv::q31>("fft q31", 256, 150.0) && ok;
+    ok = env::fft<nrv::q31>("fft q31", 4096, 140.0) && ok;
+    return ok ? 0 : 1;
+}
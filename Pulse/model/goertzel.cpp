@@ -0,0 +1,88 @@
+/**
+ * @file   goertzel.cpp
+ * @author Pratchaya Khansomboon (pratchaya.k.git@gmail.com)
+ * @brief  Goertzel filter bank against a direct DFT of the same bins, whole
+ *         blocks and blocks fed in pieces, float and double.
+ * @date   2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+#include <iostream>
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <complex>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "types.hpp"
+#include "goertzel.hpp"
+
+namespace env {
+// Bin k of the DFT of the samples, k doesn't have to be an integer
+auto direct(std::vector<nrv::f64> const& samples, nrv::f64 const& k) -> std::complex<nrv::f64> {
+    auto const N = nrv::f64(samples.size());
+    std::complex<nrv::f64> sum{};
+    for (nrv::usize n = 0; n < samples.size(); n++)
+        sum += samples[n] * std::polar(1.0, -2.0 * M_PI * k * nrv::f64(n) / N);
+    return sum;
+}
+
+/**
+ * Two sines and noise, N samples, through a bank of 11 bins, more than one
+ * lane and some of them fractional. The complex bins are compared with the
+ * direct DFT relative to the largest bin, the power with |X(k)|^2, and the
+ * same block fed in pieces of 7 samples has to give the same bins.
+ */
+template <typename T>
+auto run(nrv::usize const& N, nrv::f64 const& tolerance) -> bool {
+    std::mt19937 rng{0};
+    std::normal_distribution<nrv::f64> noise(0.0, 0.1);
+    std::vector<nrv::f64> samples(N);
+    for (nrv::usize n = 0; n < N; n++) {
+        auto const t = nrv::f64(n) / nrv::f64(N);
+        samples[n] = std::sin(2.0 * M_PI * 3.0 * t) + 0.5 * std::cos(2.0 * M_PI * 10.5 * t) + noise(rng);
+    }
+    std::vector<T> const bins{0, 1, 2, 3, T(3.5), 4, 5, 8, 10, T(10.5), 11};
+    std::vector<T> input(N);
+    std::transform(std::begin(samples), std::end(samples), std::begin(input), [](auto const& x) { return T(x); });
+
+    nrv::goertzel_bank<T> bank(bins, N);
+    std::vector<std::complex<T>> out(bins.size()), pieces(bins.size());
+    std::vector<T> power(bins.size());
+    bank.execute(input, out);
+    bank.execute(input, power);
+    bank.reset();
+    for (nrv::usize n = 0; n < N; n += 7)
+        bank.process(std::span<T const>(input).subspan(n, std::min<nrv::usize>(7, N - n)));
+    bank.result(pieces);
+
+    nrv::f64 error = 0.0, power_error = 0.0, piece_error = 0.0, scale = 0.0;
+    for (nrv::usize i = 0; i < bins.size(); i++) {
+        auto const expected = direct(samples, nrv::f64(bins[i]));
+        auto const value = std::complex<nrv::f64>(out[i]);
+        error = std::max(error, std::abs(value - expected));
+        power_error = std::max(power_error, std::abs(nrv::f64(power[i]) - std::norm(expected)));
+        piece_error = std::max(piece_error, std::abs(std::complex<nrv::f64>(pieces[i]) - value));
+        scale = std::max(scale, std::abs(expected));
+    }
+    error /= scale;
+    power_error /= scale * scale;
+    piece_error /= scale;
+    auto const ok = error < tolerance && power_error < tolerance && piece_error < tolerance;
+    std::cout << (sizeof(T) == 4 ? "float " : "double") << " N = " << N << ": relative error to the direct DFT "
+              << error << ", power " << power_error << ", in pieces " << piece_error << " " << (ok ? "ok" : "FAIL")
+              << "\n";
+    return ok;
+}
+}  // namespace env
+
+auto main([[maybe_unused]]nrv::i32 argc, [[maybe_unused]]char const* argv[]) -> nrv::i32 {
+    auto ok = true;
+    // float loses the low bins with long blocks, see goertzel_bank
+    for (auto const N : {nrv::usize{64}, nrv::usize{1000}})
+        ok = env::run<nrv::f32>(N, 2e-3) && ok;
+    for (auto const N : {nrv::usize{64}, nrv::usize{1000}, nrv::usize{4096}, nrv::usize{16384}})
+        ok = env::run<nrv::f64>(N, 1e-9) && ok;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,159 @@
+/**
+ * @file   heart_rate.cpp
+ * @author Pratchaya Khansomboon (pratchaya.k.git@gmail.com)
+ * @brief  Autocorrelation heart rate estimate against the threshold crossing
+ *         of the Pulse firmware on simulated pulse sensor recordings.
+ * @date   2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+#include <iostream>
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <random>
+
+#include "types.hpp"
+#include "ring.hpp"
+#include "sos.hpp"
+#include "sliding_minmax.hpp"
+#include "heart_rate.hpp"
+#include "pulse_filters.hpp"
+
+namespace env {
+constexpr nrv::f64 fs         = 1'000.0;
+constexpr nrv::usize seconds  = 120;
+constexpr nrv::usize decimate = 10;     // estimator at 100 Hz
+constexpr nrv::usize window   = 800;    // 8 s
+constexpr nrv::usize every    = 250;    // estimate every 250 ms
+constexpr nrv::usize settle   = 10'000; // filters and window filled
+
+struct recording {
+    std::vector<nrv::f64> x{};
+    std::vector<nrv::f64> beats{};  // time of every beat in s
+};
+
+/**
+ * 12-bit pulse sensor readings, every beat a systolic and a smaller
+ * diastolic wave. The beat intervals vary by 3 % around 60 / bpm, with
+ * breathing wander and noise on top. bpm 0 is noise only.
+ */
+auto pulse(nrv::f64 const& bpm, nrv::u32 const& seed) -> recording {
+    std::mt19937 rng{seed};
+    std::normal_distribution<nrv::f64> variation(0.0, 0.03);
+    std::normal_distribution<nrv::f64> noise(0.0, 15.0);
+    recording r{};
+    auto const count = nrv::usize(fs) * seconds;
+    if (bpm > 0.0)
+        for (auto t = 0.5; t < nrv::f64(seconds); t += 60.0 / bpm * (1.0 + variation(rng))) r.beats.push_back(t);
+
+    r.x.assign(count, 0.0);
+    for (nrv::usize n = 0; n < count; n++) {
+        auto const t = nrv::f64(n) / fs;
+        r.x[n] = 2000.0 + 150.0 * std::sin(2.0 * M_PI * 0.25 * t) + noise(rng);
+    }
+    for (auto const beat : r.beats) {
+        auto const begin = nrv::usize(std::max(0.0, (beat - 0.5) * fs));
+        auto const end = std::min(count, nrv::usize((beat + 1.0) * fs));
+        for (nrv::usize n = begin; n < end; n++) {
+            auto const t = nrv::f64(n) / fs - beat;
+            r.x[n] += 300.0 * std::exp(-0.5 * std::pow((t - 0.12) / 0.05, 2.0))
+                    + 120.0 * std::exp(-0.5 * std::pow((t - 0.35) / 0.07, 2.0));
+        }
+    }
+    for (auto& v : r.x) v = std::round(std::clamp(v, 0.0, 4095.0));
+    return r;
+}
+
+// Mean rate of the beats in the window of length seconds ending at t
+auto true_bpm(std::vector<nrv::f64> const& beats, nrv::f64 const& t, nrv::f64 const& length) -> nrv::f64 {
+    std::vector<nrv::f64> inside{};
+    for (auto const beat : beats)
+        if (beat > t - length && beat <= t) inside.push_back(beat);
+    if (inside.size() < 2) return 0.0;
+    return 60.0 * nrv::f64(inside.size() - 1) / (inside.back() - inside.front());
+}
+
+struct errors {
+    nrv::f64 sum = 0.0, max = 0.0;
+    nrv::usize count = 0;
+
+    auto add(nrv::f64 const& error) -> void {
+        sum += std::abs(error);
+        max = std::max(max, std::abs(error));
+        count++;
+    }
+    auto mean() const -> nrv::f64 { return count == 0 ? 0.0 : sum / nrv::f64(count); }
+};
+
+/**
+ * Runs the recording through the firmware's band-pass. Every 10th output
+ * goes into the estimator's history, every 250 ms the estimator runs. The
+ * firmware's threshold crossing BPM runs alongside for comparison.
+ */
+auto run(nrv::f64 const& bpm, nrv::u32 const& seed) -> bool {
+    auto const r = pulse(bpm, seed);
+    auto band_pass = nrv::cascade(nrv::sos<nrv::f32, 3>{nrv::high_pass_sos, nrv::high_pass_gain},
+                                  nrv::sos<nrv::f32, 3>{nrv::low_pass_sos, nrv::low_pass_gain});
+    nrv::ring<nrv::f32, window> history{};
+    nrv::heart_rate<nrv::f32> estimator{nrv::f32(fs / decimate), window};
+    nrv::sliding_minmax<nrv::f32, 2048> range{};
+
+    errors estimate{}, threshold{};
+    nrv::f64 confidence = 0.0, estimate_ns = 0.0;
+    nrv::usize estimates = 0;
+    nrv::f32 prev = 0.0f;
+    nrv::f64 last_beat = 0.0, last_check = -1.0;
+    nrv::f64 threshold_bpm = 0.0;
+    for (nrv::usize n = 0; n < r.x.size(); n++) {
+        auto const value = band_pass(nrv::f32(r.x[n]));
+        auto const t = nrv::f64(n) / fs;
+        if (n % decimate == 0) history.enq(value);
+
+        // The firmware: 0.75 of the buffer's maximum crossed upwards
+        range.push(value);
+        auto const top = range.max();
+        if (prev / top < 0.75f && value / top > 0.75f && t - last_check > 0.02) {
+            threshold_bpm = 60.0 / (t - last_beat);
+            last_beat = last_check = t;
+        }
+        prev = value;
+
+        if (n < settle || n % every != 0) continue;
+        auto const [first, second] = history.spans();
+        auto const start = std::chrono::steady_clock::now();
+        auto const result = estimator.estimate(first, second);
+        estimate_ns += std::chrono::duration<nrv::f64, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+        auto const expected = true_bpm(r.beats, t, nrv::f64(window * decimate) / fs);
+        confidence += nrv::f64(result.confidence);
+        estimates++;
+        if (bpm > 0.0) {
+            estimate.add(nrv::f64(result.bpm) - expected);
+            threshold.add(threshold_bpm - expected);
+        }
+    }
+
+    auto const mean_confidence = confidence / nrv::f64(estimates);
+    auto const ok = bpm > 0.0 ? estimate.mean() < 1.5 && mean_confidence > 0.5 : mean_confidence < 0.5;
+    auto const per_sample = estimate_ns / nrv::f64(r.x.size() - settle);
+    if (bpm > 0.0)
+        std::cout << bpm << " BPM: autocorrelation error mean " << estimate.mean() << ", max " << estimate.max
+                  << ", threshold crossing error mean " << threshold.mean() << ", max " << threshold.max << ", ";
+    else
+        std::cout << "noise only: ";
+    std::cout << "confidence " << mean_confidence << ", " << per_sample << " ns per sample "
+              << (ok ? "ok" : "FAIL") << "\n";
+    return ok;
+}
+}  // namespace env
+
+auto main([[maybe_unused]]nrv::i32 argc, [[maybe_unused]]char const* argv[]) -> nrv::i32 {
+    auto ok = true;
+    nrv::u32 seed = 1;
+    for (auto const bpm : {45.0, 60.0, 72.0, 90.0, 120.0, 150.0, 190.0}) ok = env::run(bpm, seed++) && ok;
+    ok = env::run(0.0, seed++) && ok;
+    return ok ? 0 : 1;
+}
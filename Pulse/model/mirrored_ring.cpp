@@ -0,0 +1,128 @@
+/**
+ * @file   mirrored_ring.cpp
+ * @author Pratchaya Khansomboon (pratchaya.k.git@gmail.com)
+ * @brief  The mirrored ring buffer against nrv::ring, and a streaming STFT
+ *         reading its frames out of either.
+ * @date   2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+#include <iostream>
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <complex>
+#include <random>
+
+#include "types.hpp"
+#include "ring.hpp"
+#include "mirrored_ring.hpp"
+#include "stft.hpp"
+
+namespace env {
+constexpr nrv::usize capacity = 1024;
+
+// Same values, oldest to newest, and the same windows
+template <typename Ring>
+auto same(nrv::mirrored_ring<nrv::i32> const& mirrored, Ring const& ring) -> bool {
+    auto ok = mirrored.size() == ring.size();
+    auto const values = mirrored.values();
+    for (nrv::usize i = 0; ok && i < ring.size(); i++)
+        ok = values[i] == ring.at_front(i) && mirrored.at_back(i) == ring.at_back(i);
+    for (nrv::usize lag = 0; ok && lag < ring.size(); lag += 37) {
+        auto const window = mirrored.window(lag, ring.size() - lag);
+        ok = window.data() + window.size() == values.data() + values.size() - lag && window.back() == ring.at_back(lag);
+    }
+    return ok;
+}
+
+// Random single and block enq, enq_keep and deq on both rings
+auto operations() -> bool {
+    std::mt19937 rng{0};
+    std::uniform_int_distribution<nrv::i32> operation(0, 9);
+    std::uniform_int_distribution<nrv::usize> length(0, 3 * capacity / 2);
+    nrv::mirrored_ring<nrv::i32> mirrored{capacity - 24};
+    nrv::ring<nrv::i32, capacity> ring{};
+
+    auto ok = mirrored.capacity() == capacity && same(mirrored, ring);
+    nrv::i32 next = 0;
+    for (nrv::usize i = 0; ok && i < 5'000; i++) {
+        auto const op = operation(rng);
+        if (op < 4) {
+            ring.enq(next);
+            mirrored.enq(next++);
+        } else if (op < 6) {
+            std::vector<nrv::i32> block(length(rng));
+            for (auto& value : block) {
+                value = next++;
+                ring.enq(value);
+            }
+            mirrored.enq(std::span<nrv::i32 const>(block));
+        } else if (op < 7) {
+            ring.enq_keep(next);
+            mirrored.enq_keep(next++);
+        } else if (ring.size() > 0) {
+            ok = ring.deq() == mirrored.deq();
+        }
+        ok = ok && same(mirrored, ring);
+    }
+    std::cout << "mirrored_ring " << mirrored.capacity() << ": " << (ok ? "ok" : "FAIL") << "\n";
+    return ok;
+}
+
+/**
+ * Streams a noisy chirp in blocks of 16 through both rings into two STFTs.
+ * The frames are the same samples times the same window, the spectra have
+ * to match exactly. Times every update() call.
+ */
+auto spectrogram() -> bool {
+    constexpr nrv::usize sample_count = 2'000'000;
+    constexpr nrv::usize block = 16;
+    std::mt19937 rng{0};
+    std::uniform_real_distribution<nrv::f64> noise(-0.1, 0.1);
+    std::vector<nrv::f64> x(sample_count);
+    for (nrv::usize n = 0; n < sample_count; n++) {
+        auto const t = nrv::f64(n) / 1000.0;
+        x[n] = std::sin(2.0 * M_PI * (5.0 * t + 0.05 * t * t)) + noise(rng);
+    }
+
+    nrv::ring<nrv::f64, capacity> ring{};
+    nrv::mirrored_ring<nrv::f64> mirrored{capacity};
+    nrv::stft<nrv::f64> from_ring{512, 32}, from_mirrored{512, 32};
+    std::vector<std::complex<nrv::f64>> bins(from_ring.bins());
+
+    using clock = std::chrono::steady_clock;
+    clock::duration ring_time{}, mirrored_time{};
+    auto ok = true;
+    for (nrv::usize i = 0; i < sample_count; i += block) {
+        for (nrv::usize j = i; j < i + block; j++) ring.enq(x[j]);
+        mirrored.enq(std::span<nrv::f64 const>(x).subspan(i, block));
+
+        auto const start = clock::now();
+        from_ring.update(ring, block, [&](auto const& frame) { std::copy(std::begin(frame), std::end(frame), std::begin(bins)); });
+        auto const middle = clock::now();
+        from_mirrored.update(mirrored, block, [&](auto const& frame) {
+            ok = ok && std::equal(std::begin(frame), std::end(frame), std::begin(bins));
+        });
+        ring_time += middle - start;
+        mirrored_time += clock::now() - middle;
+    }
+    ok = ok && from_ring.frames() == from_mirrored.frames() && from_mirrored.dropped() == 0;
+
+    auto const us = [&](clock::duration const& time) {
+        return std::chrono::duration<nrv::f64, std::micro>(time).count() / nrv::f64(from_ring.frames());
+    };
+    std::cout << "stft 512, hop 32, " << from_ring.frames() << " frames: ring " << us(ring_time)
+              << " us per frame, mirrored_ring " << us(mirrored_time) << " us per frame "
+              << (ok ? "ok" : "FAIL") << "\n";
+    return ok;
+}
+}  // namespace env
+
+auto main([[maybe_unused]]nrv::i32 argc, [[maybe_unused]]char const* argv[]) -> nrv::i32 {
+    auto ok = env::operations();
+    ok = env::spectrogram() && ok;
+    return ok ? 0 : 1;
+}
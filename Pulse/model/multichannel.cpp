@@ -0,0 +1,110 @@
+/**
+ * @file   multichannel.cpp
+ * @author Pratchaya Khansomboon (pratchaya.k.git@gmail.com)
+ * @brief  Lockstep multichannel FIR and SOS filters against one single
+ *         channel filter per channel, interleaved and planar.
+ * @date   2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+#include <iostream>
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <random>
+
+#include "types.hpp"
+#include "fir.hpp"
+#include "sos.hpp"
+#include "multichannel.hpp"
+#include "pulse_filters.hpp"
+
+namespace env {
+constexpr nrv::usize frames = 3'000;
+constexpr nrv::usize block  = 250;
+
+// C channels of sensor data, planar
+template <typename T, nrv::usize C>
+auto recording() -> std::vector<T> {
+    std::mt19937 rng{C};
+    std::normal_distribution<nrv::f64> noise(0.0, 20.0);
+    std::vector<T> x(C * frames);
+    for (nrv::usize c = 0; c < C; c++)
+        for (nrv::usize n = 0; n < frames; n++) {
+            auto const t = nrv::f64(n) / 1000.0;
+            x[c * frames + n] = T(2000.0 + 300.0 * std::sin(2.0 * M_PI * (1.0 + 0.1 * nrv::f64(c)) * t) + noise(rng));
+        }
+    return x;
+}
+
+/**
+ * Filters the recording per channel with a filter of make(), in blocks of both layouts
+ * with the multichannel filter, and compares the outputs.
+ */
+template <typename T, nrv::usize C, typename Multi, typename Make>
+auto run(char const* name, Multi multi, Make const& make, nrv::f64 const& tolerance) -> bool {
+    auto const x = recording<T, C>();
+    std::vector<T> expected(x.size());
+    nrv::f64 amplitude = 0.0;
+    for (nrv::usize c = 0; c < C; c++) {
+        auto filter = make();
+        for (nrv::usize n = 0; n < frames; n++) {
+            expected[c * frames + n] = filter(x[c * frames + n]);
+            amplitude = std::max(amplitude, std::abs(nrv::f64(expected[c * frames + n])));
+        }
+    }
+
+    auto ok = true;
+    for (auto const layout : {nrv::channel_layout::planar, nrv::channel_layout::interleaved}) {
+        auto const planar = layout == nrv::channel_layout::planar;
+        auto filter = multi;
+        std::vector<T> buffer(block * C), out(x.size());
+        for (nrv::usize i = 0; i < frames; i += block) {
+            for (nrv::usize c = 0; c < C; c++)
+                for (nrv::usize n = 0; n < block; n++)
+                    buffer[planar ? c * block + n : n * C + c] = x[c * frames + i + n];
+            filter.process(buffer, buffer, layout);
+            for (nrv::usize c = 0; c < C; c++)
+                for (nrv::usize n = 0; n < block; n++)
+                    out[c * frames + i + n] = buffer[planar ? c * block + n : n * C + c];
+        }
+
+        nrv::f64 max_error = 0.0;
+        for (nrv::usize i = 0; i < out.size(); i++)
+            max_error = std::max(max_error, std::abs(nrv::f64(out[i]) - nrv::f64(expected[i])));
+        auto const good = max_error <= tolerance * amplitude;
+        std::cout << name << " " << C << " channels " << (planar ? "planar" : "interleaved") << ": max error "
+                  << max_error << " " << (good ? "ok" : "FAIL") << "\n";
+        ok = ok && good;
+    }
+    return ok;
+}
+
+template <typename T>
+auto band_pass() -> nrv::sos<T, 6> {
+    return nrv::cascade(nrv::sos<T, 3>{nrv::high_pass_sos, nrv::high_pass_gain},
+                        nrv::sos<T, 3>{nrv::low_pass_sos, nrv::low_pass_gain});
+}
+}  // namespace env
+
+auto main([[maybe_unused]]nrv::i32 argc, [[maybe_unused]]char const* argv[]) -> nrv::i32 {
+    auto const b32 = nrv::make_lowpass<nrv::f32>(61, 0.02);
+    auto const b64 = nrv::make_lowpass<nrv::f64>(61, 0.02);
+    // Same operations per channel as sos, the outputs are identical
+    auto const sos32 = env::band_pass<nrv::f32>;
+    auto const sos64 = env::band_pass<nrv::f64>;
+    auto const fir32 = [&] { return nrv::fir<nrv::f32>{b32}; };
+    auto const fir64 = [&] { return nrv::fir<nrv::f64>{b64}; };
+
+    auto ok = true;
+    // Same operations per channel as sos, the outputs are identical
+    ok = env::run<nrv::f32, 4>("sos", nrv::multichannel_sos<nrv::f32, 6, 4>{sos32()}, sos32, 0.0) && ok;
+    ok = env::run<nrv::f32, 8>("sos", nrv::multichannel_sos<nrv::f32, 6, 8>{sos32()}, sos32, 0.0) && ok;
+    ok = env::run<nrv::f64, 16>("sos", nrv::multichannel_sos<nrv::f64, 6, 16>{sos64()}, sos64, 0.0) && ok;
+    // The taps are summed in another order than fir's dot product
+    ok = env::run<nrv::f32, 8>("fir", nrv::multichannel_fir<nrv::f32, 8>{b32}, fir32, 1e-6) && ok;
+    ok = env::run<nrv::f32, 16>("fir", nrv::multichannel_fir<nrv::f32, 16>{b32}, fir32, 1e-6) && ok;
+    ok = env::run<nrv::f64, 4>("fir", nrv::multichannel_fir<nrv::f64, 4>{b64}, fir64, 1e-12) && ok;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,92 @@
+/**
+ * @file   resample.cpp
+ * @author Pratchaya Khansomboon (pratchaya.k.git@gmail.com)
+ * @brief  Decimation of the 1 kHz pulse stream to 100 and 50 Hz, and the
+ *         interpolating, rational and fractional resamplers on sines.
+ * @date   2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+#include <iostream>
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <random>
+
+#include "types.hpp"
+#include "resample.hpp"
+
+namespace env {
+// Heart rate band content, a beat at 1.2 Hz with a few harmonics
+auto pulse(nrv::f64 t) -> nrv::f64 {
+    return std::sin(2.0 * M_PI * 1.2 * t) + 0.4 * std::sin(2.0 * M_PI * 2.4 * t + 0.3)
+         + 0.2 * std::sin(2.0 * M_PI * 3.6 * t + 0.7);
+}
+
+/**
+ * Run the samples of signal(t) at fs_in through the resampler in blocks, and
+ * compare every output after the filter settled with the clean signal at the
+ * output time minus the filter delay.
+ */
+template <typename Resampler, typename Signal, typename Clean>
+auto run(char const* name, Resampler& r, nrv::f64 const& fs_in, nrv::f64 const& fs_out,
+         Signal&& signal, Clean&& clean, nrv::f64 const& tolerance) -> bool {
+    constexpr nrv::usize sample_count = 20'000;
+    constexpr nrv::usize block = 100;
+
+    std::vector<nrv::f64> in(block), out{};
+    std::vector<nrv::f64> buffer(r.output_size(block) + 1);
+    for (nrv::usize i = 0; i < sample_count; i += block) {
+        for (nrv::usize j = 0; j < block; j++) in[j] = signal(nrv::f64(i + j) / fs_in);
+        buffer.resize(r.output_size(block));
+        auto const n = r.process(in, buffer);
+        out.insert(std::end(out), std::begin(buffer), std::begin(buffer) + nrv::isize(n));
+    }
+
+    auto const settle = nrv::usize(std::ceil((2.0 * r.delay() + 1.0) * fs_out / fs_in));
+    nrv::f64 max_error = 0.0;
+    for (nrv::usize m = settle; m < out.size(); m++) {
+        auto const t = nrv::f64(m) / fs_out - r.delay() / fs_in;
+        max_error = std::max(max_error, std::abs(out[m] - clean(t)));
+    }
+
+    auto const expected = nrv::usize(std::ceil(nrv::f64(sample_count) * fs_out / fs_in - 1e-9));
+    auto const ok = max_error < tolerance && out.size() == expected;
+    std::cout << name << ": " << fs_in << " Hz to " << fs_out << " Hz, " << out.size() << " outputs, "
+              << r.taps() << " taps in " << r.phases() << " phases, max error " << max_error
+              << " " << (ok ? "ok" : "FAIL") << "\n";
+    return ok;
+}
+}  // namespace env
+
+auto main([[maybe_unused]]nrv::i32 argc, [[maybe_unused]]char const* argv[]) -> nrv::i32 {
+    std::mt19937 rng{0};
+    std::normal_distribution<nrv::f64> noise(0.0, 0.05);
+
+    // The Pulse stream: heart rate band, 50 Hz mains hum and noise at 1 kHz.
+    // The decimators remove everything above the new Nyquist frequency.
+    auto const noisy = [&](nrv::f64 t) { return env::pulse(t) + 0.5 * std::sin(2.0 * M_PI * 50.0 * t) + noise(rng); };
+    auto const sine  = [](nrv::f64 t) { return std::sin(2.0 * M_PI * 3.0 * t); };
+
+    auto ok = true;
+    auto to_100 = nrv::make_decimator<nrv::f64>(10);
+    ok = env::run("decimate", to_100, 1000.0, 100.0, noisy, env::pulse, 0.1) && ok;
+    auto to_50 = nrv::make_decimator<nrv::f64>(20);
+    ok = env::run("decimate", to_50, 1000.0, 50.0, noisy, env::pulse, 0.1) && ok;
+
+    auto up = nrv::make_interpolator<nrv::f64>(4);
+    ok = env::run("interpolate", up, 100.0, 400.0, sine, sine, 1e-3) && ok;
+    nrv::resampler<nrv::f64> rational{3, 2};
+    ok = env::run("rational", rational, 100.0, 150.0, sine, sine, 1e-3) && ok;
+    nrv::resampler<nrv::f64> reduced{30, 20};
+    ok = env::run("rational", reduced, 100.0, 150.0, sine, sine, 1e-3) && ok;
+    nrv::fractional_resampler<nrv::f64> fractional{64.0 / 1000.0};
+    ok = env::run("fractional", fractional, 1000.0, 64.0, noisy, env::pulse, 0.1) && ok;
+    nrv::fractional_resampler<nrv::f64> drift{1.0 / 0.9993};
+    ok = env::run("fractional", drift, 100.0, 100.0 / 0.9993, sine, sine, 1e-3) && ok;
+
+    std::cout << "Decimating by 10 costs " << nrv::f64(to_100.taps()) / 10.0 << " multiplies per input sample, "
+              << to_100.taps() << " when filtering at 1 kHz and dropping 9 of 10 outputs\n";
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,92 @@
+/**
+ * @file   ring.cpp
+ * @author Pratchaya Khansomboon (pratchaya.k.git@gmail.com)
+ * @brief  The ring buffer against a std::deque of the same values, a power of
+ *         two and another capacity.
+ * @date   2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+#include <iostream>
+#include <vector>
+#include <deque>
+#include <algorithm>
+#include <iterator>
+#include <random>
+
+#include "types.hpp"
+#include "ring.hpp"
+
+static_assert(std::random_access_iterator<nrv::ring<nrv::f32, 16>::iterator>);
+static_assert(std::random_access_iterator<nrv::ring<nrv::f32, 16>::const_iterator>);
+
+namespace env {
+// Every way of reading the ring gives the values of expected, oldest first
+template <typename Ring>
+auto same(Ring const& ring, std::deque<nrv::i32> const& expected) -> bool {
+    auto const size = expected.size();
+    auto ok = ring.size() == size;
+    ok = ok && std::distance(std::begin(ring), std::end(ring)) == std::ptrdiff_t(size);
+    ok = ok && std::equal(std::begin(ring), std::end(ring), std::begin(expected), std::end(expected));
+    ok = ok && std::equal(std::rbegin(ring), std::rend(ring), std::rbegin(expected), std::rend(expected));
+    for (nrv::usize i = 0; ok && i < size; i++) {
+        ok = ring.at_front(i) == expected[i] && ring.at_back(i) == expected[size - 1 - i];
+        ok = ok && std::begin(ring)[std::ptrdiff_t(i)] == expected[i] && *(std::end(ring) - std::ptrdiff_t(i + 1)) == ring[i];
+    }
+
+    auto const [first, second] = ring.spans();
+    std::vector<nrv::i32> joined(std::begin(first), std::end(first));
+    joined.insert(std::end(joined), std::begin(second), std::end(second));
+    ok = ok && std::equal(std::begin(joined), std::end(joined), std::begin(expected), std::end(expected));
+    // and the spans are views of the storage, not copies
+    for (nrv::usize i = 0; ok && i < size; i++) {
+        auto const* in_span = i < first.size() ? first.data() + i : second.data() + (i - first.size());
+        ok = &ring.at_front(i) == in_span;
+    }
+    return ok;
+}
+
+// Random enq, enq_keep and deq, checked after every operation
+template <nrv::usize SIZE>
+auto run() -> bool {
+    std::mt19937 rng{SIZE};
+    std::uniform_int_distribution<nrv::i32> operation(0, 9);
+    nrv::ring<nrv::i32, SIZE> ring{};
+    std::deque<nrv::i32> expected{};
+
+    auto ok = same(ring, expected);
+    nrv::usize wrapped = 0;
+    for (nrv::i32 i = 0; ok && i < 20'000; i++) {
+        auto const op = operation(rng);
+        if (op < 6) {                     // enq, drops the oldest when full
+            ring.enq(i);
+            expected.push_back(i);
+            if (expected.size() > SIZE) expected.pop_front();
+        } else if (op < 7) {              // enq_keep, nothing when full
+            ring.enq_keep(i);
+            if (expected.size() < SIZE) expected.push_back(i);
+        } else if (!expected.empty()) {   // deq the oldest
+            ok = ring.deq() == expected.front();
+            expected.pop_front();
+        }
+        ok = ok && same(ring, expected);
+        wrapped += ring.spans()[1].empty() ? 0 : 1;
+    }
+
+    // The iterators write through to the ring
+    for (auto& value : ring) value = -value;
+    for (auto& value : expected) value = -value;
+    ok = ok && same(ring, expected) && (wrapped > 0 || SIZE == 1);
+    std::cout << "ring " << SIZE << ": " << (ok ? "ok" : "FAIL") << "\n";
+    return ok;
+}
+}  // namespace env
+
+auto main([[maybe_unused]]nrv::i32 argc, [[maybe_unused]]char const* argv[]) -> nrv::i32 {
+    auto ok = true;
+    ok = env::run<1>() && ok;
+    ok = env::run<16>() && ok;
+    ok = env::run<100>() && ok;
+    ok = env::run<2048>() && ok;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,88 @@
+/**
+ * @file   sdft.cpp
+ * @author Pratchaya Khansomboon (pratchaya.k.git@gmail.com)
+ * @brief  Sliding DFT of the heart rate band against a direct DFT of the
+ *         window, over an hour of a simulated 1 kHz pulse stream.
+ * @date   2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+#include <iostream>
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <complex>
+#include <algorithm>
+#include <random>
+
+#include "types.hpp"
+#include "ring.hpp"
+#include "sos.hpp"
+#include "sdft.hpp"
+#include "pulse_filters.hpp"
+
+namespace env {
+constexpr nrv::f64 fs        = 1'000.0;
+constexpr nrv::usize window  = 2000;             // 0.5 Hz per bin
+constexpr nrv::usize seconds = 3600;
+constexpr nrv::usize check   = 600 * 1000;       // compare every 10 minutes
+
+// Bin k of the DFT of the window ending at the newest sample of the ring
+auto direct(nrv::ring<nrv::f32, 2048> const& samples, nrv::usize const& k) -> std::complex<nrv::f64> {
+    std::complex<nrv::f64> sum{};
+    for (nrv::usize n = 0; n < window; n++) {
+        auto const value = nrv::f64(samples.at_back(window - 1 - n));
+        sum += value * std::polar(1.0, -2.0 * M_PI * nrv::f64(k * n) / nrv::f64(window));
+    }
+    return sum;
+}
+
+/**
+ * The band-pass filtered pulse at bpm goes into a ring and the sdft of bins
+ * 1 to 6, 0.5 to 3 Hz, like the firmware's data_buffer. Every 10 minutes all
+ * bins are compared with the direct DFT and the strongest bin with the pulse
+ * rate.
+ */
+auto run(nrv::f64 const& bpm) -> bool {
+    std::mt19937 rng{0};
+    std::normal_distribution<nrv::f64> noise(0.0, 15.0);
+    auto band_pass = nrv::cascade(nrv::sos<nrv::f32, 3>{nrv::high_pass_sos, nrv::high_pass_gain},
+                                  nrv::sos<nrv::f32, 3>{nrv::low_pass_sos, nrv::low_pass_gain});
+    nrv::ring<nrv::f32, 2048> samples{};
+    nrv::sdft<nrv::f32, window, 6> band{{1, 2, 3, 4, 5, 6}};
+
+    auto ok = true;
+    nrv::f64 worst = 0.0;
+    for (nrv::usize n = 1; n <= nrv::usize(fs) * seconds; n++) {
+        auto const t = nrv::f64(n) / fs;
+        auto const phase = std::fmod(t * bpm / 60.0, 1.0);
+        auto const x = 2000.0 + 300.0 * std::exp(-0.5 * std::pow((phase - 0.12) / 0.05, 2.0)) + noise(rng);
+        samples.enq(band_pass(nrv::f32(std::round(x))));
+        band.update(samples);
+        if (n % check != 0) continue;
+
+        nrv::f64 error = 0.0, scale = 0.0;
+        nrv::usize peak = 0;
+        for (nrv::usize i = 0; i < band.size(); i++) {
+            auto const expected = direct(samples, band.bin_index(i));
+            auto const value = std::complex<nrv::f64>(band[i]);
+            error = std::max(error, std::abs(value - expected));
+            scale = std::max(scale, std::abs(expected));
+            if (band.power(i) > band.power(peak)) peak = i;
+        }
+        worst = std::max(worst, error / scale);
+        // The strongest bin is the one nearest to the pulse rate
+        auto const nearest = std::abs(nrv::f64(band.frequency(peak, nrv::f32(fs))) - bpm / 60.0) <= 0.25;
+        ok = ok && nearest;
+    }
+    ok = ok && worst < 1e-3;
+    std::cout << bpm << " BPM, " << seconds / 60 << " minutes: relative error to the direct DFT " << worst << " "
+              << (ok ? "ok" : "FAIL") << "\n";
+    return ok;
+}
+}  // namespace env
+
+auto main([[maybe_unused]]nrv::i32 argc, [[maybe_unused]]char const* argv[]) -> nrv::i32 {
+    auto ok = true;
+    for (auto const bpm : {60.0, 90.0, 150.0}) ok = env::run(bpm) && ok;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,123 @@
+/**
+ * @file   sliding_minmax.cpp
+ * @author Pratchaya Khansomboon (pratchaya.k.git@gmail.com)
+ * @brief  Sliding window minimum and maximum against a scan of the ring
+ *         every sample, like the Pulse display scaling.
+ * @date   2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+#include <iostream>
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <random>
+
+#include "types.hpp"
+#include "ring.hpp"
+#include "sliding_minmax.hpp"
+
+namespace env {
+constexpr nrv::usize sample_count = 100'000;
+
+template <typename F>
+auto time_ns(F&& f) -> nrv::f64 {
+    auto const start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<nrv::f64, std::nano>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Pulse at 1.2 Hz with noise and wander sampled at 1 kHz, runs of equal
+// values from the quantisation
+auto pulse() -> std::vector<nrv::f32> {
+    std::mt19937 rng{0};
+    std::normal_distribution<nrv::f64> noise(0.0, 20.0);
+    std::vector<nrv::f32> x(sample_count);
+    for (nrv::usize n = 0; n < sample_count; n++) {
+        auto const t = nrv::f64(n) / 1000.0;
+        auto const v = 2000.0 + 300.0 * std::sin(2.0 * M_PI * 1.2 * t) + 100.0 * std::sin(2.0 * M_PI * 0.1 * t);
+        x[n] = nrv::f32(std::round(v + noise(rng)));
+    }
+    return x;
+}
+
+/**
+ * Pushes x into a ring and the tracker of SIZE and compares min and max
+ * with a scan of the ring after every sample. Then times both per sample,
+ * the scan once with at_back() like the old firmware and once over spans().
+ */
+template <nrv::usize SIZE>
+auto run(std::vector<nrv::f32> const& x) -> bool {
+    auto ok = true;
+    {
+        nrv::ring<nrv::f32, SIZE> ring{};
+        nrv::sliding_minmax<nrv::f32, SIZE> range{};
+        for (auto const value : x) {
+            ring.enq(value);
+            range.push(value);
+            auto const [lo, hi] = std::minmax_element(std::begin(ring), std::end(ring));
+            ok = ok && range.min() == *lo && range.max() == *hi && range.size() == ring.size();
+        }
+    }
+
+    nrv::f32 sink = 0.0f;
+    auto const per_sample = [&](auto&& body) {
+        nrv::f64 best = 1e300;
+        for (nrv::usize repeat = 0; repeat < 3; repeat++) best = std::min(best, time_ns(body));
+        return best / nrv::f64(x.size());
+    };
+    auto const at_back_ns = per_sample([&] {
+        nrv::ring<nrv::f32, SIZE> ring{};
+        for (auto const value : x) {
+            ring.enq(value);
+            nrv::f32 lo = value, hi = value;
+            for (nrv::usize i = 0; i < ring.size(); i++) {
+                lo = std::min(lo, ring.at_back(i));
+                hi = std::max(hi, ring.at_back(i));
+            }
+            sink += hi - lo;
+        }
+    });
+    auto const spans_ns = per_sample([&] {
+        nrv::ring<nrv::f32, SIZE> ring{};
+        for (auto const value : x) {
+            ring.enq(value);
+            nrv::f32 lo = value, hi = value;
+            for (auto const part : ring.spans()) {
+                for (auto const v : part) {
+                    lo = std::min(lo, v);
+                    hi = std::max(hi, v);
+                }
+            }
+            sink += hi - lo;
+        }
+    });
+    auto const sliding_ns = per_sample([&] {
+        nrv::ring<nrv::f32, SIZE> ring{};
+        nrv::sliding_minmax<nrv::f32, SIZE> range{};
+        for (auto const value : x) {
+            ring.enq(value);
+            range.push(value);
+            sink += range.max() - range.min();
+        }
+    });
+
+    std::cout << "window " << SIZE << ": sliding " << sliding_ns << " ns/sample, scan with at_back " << at_back_ns
+              << " ns/sample, scan over spans " << spans_ns << " ns/sample " << (ok ? "ok" : "FAIL") << "\n";
+    // Used, so the timed loops aren't optimised away
+    if (sink == 0.0f) std::cout << "";
+    return ok;
+}
+}  // namespace env
+
+auto main([[maybe_unused]]nrv::i32 argc, [[maybe_unused]]char const* argv[]) -> nrv::i32 {
+    auto const x = env::pulse();
+    auto ok = true;
+    ok = env::run<1>(x) && ok;
+    ok = env::run<7>(x) && ok;
+    ok = env::run<64>(x) && ok;
+    ok = env::run<2048>(x) && ok;
+    return ok ? 0 : 1;
+}
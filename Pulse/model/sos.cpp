@@ -0,0 +1,69 @@
+/**
+ * @file   sos.cpp
+ * @author Pratchaya Khansomboon (pratchaya.k.git@gmail.com)
+ * @brief  The Pulse band-pass as direct form polynomials against the fused
+ *         second order section cascade, in double and float.
+ * @date   2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+#include <iostream>
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <array>
+
+#include "types.hpp"
+#include "iir.hpp"
+#include "sos.hpp"
+#include "pulse_filters.hpp"
+
+namespace env {
+template <typename T>
+auto band_pass() -> nrv::sos<T, 6> {
+    return nrv::cascade(nrv::sos<T, 3>{nrv::high_pass_sos, nrv::high_pass_gain},
+                        nrv::sos<T, 3>{nrv::low_pass_sos, nrv::low_pass_gain});
+}
+
+// ADC reading of the pulse sensor, offset, beat, baseline wander and hum
+auto sensor(nrv::f64 t) -> nrv::f64 {
+    return 2000.0 + 300.0 * std::sin(2.0 * M_PI * 1.2 * t) + 200.0 * std::cos(2.0 * M_PI * 0.05 * t)
+         + 50.0 * std::sin(2.0 * M_PI * 50.0 * t);
+}
+}  // namespace env
+
+auto main([[maybe_unused]]nrv::i32 argc, [[maybe_unused]]char const* argv[]) -> nrv::i32 {
+    constexpr auto fs = 1'000.0;
+    constexpr nrv::usize sample_count = 60'000;
+    constexpr nrv::usize settle = 20'000;
+
+    // The direct form polynomials of main.cpp before, 13 significant digits
+    nrv::iir_of<nrv::f64, nrv::high_pass_tf> hp64{};
+    nrv::iir_of<nrv::f64, nrv::low_pass_tf> lp64{};
+    nrv::iir_of<nrv::f32, nrv::high_pass_tf> hp32{};
+    nrv::iir_of<nrv::f32, nrv::low_pass_tf> lp32{};
+    auto sos64 = env::band_pass<nrv::f64>();
+    auto sos32 = env::band_pass<nrv::f32>();
+
+    nrv::f64 direct64_error = 0.0, direct32_error = 0.0, sos32_error = 0.0, amplitude = 0.0;
+    for (nrv::usize n = 0; n < sample_count; n++) {
+        auto const x = env::sensor(nrv::f64(n) / fs);
+        auto const reference = sos64(x);
+        auto const direct64  = lp64(hp64(x));
+        auto const direct32  = lp32(hp32(nrv::f32(x)));
+        auto const fused32   = sos32(nrv::f32(x));
+        if (n < settle) continue;
+        amplitude = std::max(amplitude, std::abs(reference));
+        direct64_error = std::max(direct64_error, std::abs(direct64 - reference));
+        sos32_error    = std::max(sos32_error, std::abs(nrv::f64(fused32) - reference));
+        direct32_error = std::isfinite(direct32) ? std::max(direct32_error, std::abs(nrv::f64(direct32) - reference))
+                                                 : INFINITY;
+    }
+
+    std::cout << "Band-pass output amplitude " << amplitude << ", max error against the f64 SOS cascade\n";
+    std::cout << "  f64 direct form: " << direct64_error << "\n";
+    std::cout << "  f32 direct form: " << direct32_error << "\n";
+    std::cout << "  f32 SOS cascade: " << sos32_error << "\n";
+    return std::isfinite(sos32_error) && sos32_error < 0.01 * amplitude ? 0 : 1;
+}
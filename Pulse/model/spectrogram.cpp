@@ -0,0 +1,72 @@
+/**
+ * @file   spectrogram.cpp
+ * @author Pratchaya Khansomboon (pratchaya.k.git@gmail.com)
+ * @brief  Streaming STFT of a chirp sampled at 1 kHz, the samples go through a
+ *         ring buffer like on the Pulse.
+ * @date   2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+#include <iostream>
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <fstream>
+#include <random>
+
+#include "types.hpp"
+#include "ring.hpp"
+#include "stft.hpp"
+
+auto main([[maybe_unused]]nrv::i32 argc, [[maybe_unused]]char const* argv[]) -> nrv::i32 {
+    constexpr auto fs = 1'000.0;
+    constexpr auto Ts = 1.0 / fs;
+    constexpr nrv::usize sample_count = 20'000;
+
+    // Linear chirp from 5 Hz to 200 Hz with some noise
+    constexpr auto f0 = 5.0;
+    constexpr auto f1 = 200.0;
+    constexpr auto duration = Ts * sample_count;
+    std::mt19937 rng{0};
+    std::uniform_real_distribution<nrv::f64> noise(-0.1, 0.1);
+    auto chirp = [&](nrv::f64 t) {
+        return std::sin(2.0 * M_PI * (f0 * t + (f1 - f0) / (2.0 * duration) * t * t)) + noise(rng);
+    };
+
+    nrv::ring<nrv::f64, 1024> samples{};
+    nrv::stft<nrv::f64> spectrum{256, 64};
+
+    std::ofstream plot_data{"spectrogram.csv"};
+    plot_data << "time";
+    for (nrv::usize k = 0; k < spectrum.bins(); k++) plot_data << "," << spectrum.frequency(k, fs);
+    plot_data << "\n";
+
+    // Samples arrive in blocks of 16, like a display refresh draining the ADC
+    constexpr nrv::usize block = 16;
+    nrv::f64 max_error = 0.0;
+    for (nrv::usize i = 0; i < sample_count; i += block) {
+        for (nrv::usize j = i; j < i + block; j++) samples.enq(chirp(Ts * nrv::f64(j)));
+
+        spectrum.update(samples, block, [&](auto const& bins) {
+            // Frame centre and the chirp frequency at that time
+            auto const end = spectrum.frame_size() - 1 + (spectrum.frames() - 1) * spectrum.hop();
+            auto const t   = Ts * (nrv::f64(end) - nrv::f64(spectrum.frame_size()) / 2.0);
+            auto const expected = f0 + (f1 - f0) * t / duration;
+
+            auto const peak = std::max_element(std::begin(bins), std::end(bins),
+                [](auto const& a, auto const& b) { return std::abs(a) < std::abs(b); });
+            auto const found = spectrum.frequency(nrv::usize(peak - std::begin(bins)), fs);
+            max_error = std::max(max_error, std::abs(found - expected));
+
+            plot_data << t;
+            for (auto const& b : bins) plot_data << "," << 20.0 * std::log10(std::abs(b) + 1e-12);
+            plot_data << "\n";
+        });
+    }
+
+    std::cout << "STFT " << spectrum.frames() << " frames, " << spectrum.dropped() << " dropped\n";
+    std::cout << "Peak frequency error " << max_error << " Hz, bin width "
+              << spectrum.frequency(1, fs) << " Hz\n";
+    return 0;
+}
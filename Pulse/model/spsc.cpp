@@ -0,0 +1,117 @@
+/**
+ * @file   spsc.cpp
+ * @author Pratchaya Khansomboon (pratchaya.k.git@gmail.com)
+ * @brief  Stress test of the single producer, single consumer queue with a
+ *         producer and a consumer thread, flat out and paced at 1 MHz.
+ * @date   2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+#include <iostream>
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "types.hpp"
+#include "spsc.hpp"
+
+namespace env {
+using clock = std::chrono::steady_clock;
+
+// Sample like the firmware's, the time it was taken and a sequence number
+struct sample {
+    nrv::i64 time;
+    nrv::u64 sequence;
+};
+
+/**
+ * The producer pushes count samples, one at a time, and the consumer pops
+ * them in batches. Flat out the producer retries a full queue, paced it
+ * pushes a sample every period and drops it when full, like the sampling
+ * task. The consumer has to see every sample that wasn't dropped exactly
+ * once and in order.
+ */
+template <nrv::usize SIZE>
+auto run(char const* name, nrv::u64 const& count, std::chrono::nanoseconds const& period) -> bool {
+    static nrv::spsc<sample, SIZE> queue{};
+    auto const paced = period.count() > 0;
+    nrv::u64 dropped = 0;
+    std::atomic<bool> done{false};
+
+    auto const start = clock::now();
+    std::thread producer{[&] {
+        for (nrv::u64 i = 0; i < count; i++) {
+            auto const due = start + period * i;
+            if (paced) while (clock::now() < due) {}
+            sample const value{(clock::now() - start).count(), i};
+            if (paced) {
+                if (!queue.push(value)) dropped++;
+            } else {
+                while (!queue.push(value)) std::this_thread::yield();
+            }
+        }
+        done.store(true, std::memory_order_release);
+    }};
+
+    nrv::u64 received = 0, next = 0, reordered = 0, batches = 0;
+    nrv::i64 max_latency = 0;
+    std::array<sample, 64> batch{};
+    while (true) {
+        auto const n = queue.pop(batch);
+        if (n == 0) {
+            // Nothing can follow once the producer is done and the queue is empty
+            if (done.load(std::memory_order_acquire) && queue.empty()) break;
+            std::this_thread::yield();
+            continue;
+        }
+        auto const now = (clock::now() - start).count();
+        for (nrv::usize j = 0; j < n; j++) {
+            if (batch[j].sequence < next) reordered++;
+            next = batch[j].sequence + 1;
+            max_latency = std::max(max_latency, now - batch[j].time);
+        }
+        received += n;
+        batches++;
+    }
+    auto const seconds = std::chrono::duration<nrv::f64>(clock::now() - start).count();
+    producer.join();
+
+    auto const ok = reordered == 0 && received + dropped == count && queue.empty() && (paced || dropped == 0);
+    std::cout << name << ": " << received << " received, " << dropped << " dropped, "
+              << nrv::f64(count) / seconds / 1e6 << " M samples/s, " << nrv::f64(received) / nrv::f64(batches)
+              << " per batch, max latency " << nrv::f64(max_latency) / 1e3 << " us " << (ok ? "ok" : "FAIL") << "\n";
+    return ok;
+}
+
+// Batch push and pop across the wrap around of the storage
+auto batches() -> bool {
+    nrv::spsc<nrv::u32, 16> queue{};
+    std::vector<nrv::u32> in(7), out(16);
+    nrv::u32 pushed = 0, popped = 0;
+    auto ok = true;
+    for (nrv::usize round = 0; round < 1000; round++) {
+        for (auto& value : in) value = pushed++;
+        auto const n = queue.push(std::span<nrv::u32 const>(in));
+        pushed -= nrv::u32(in.size() - n);
+        ok = ok && queue.size() <= queue.capacity();
+        auto const m = queue.pop(std::span<nrv::u32>(out).first(round % 16 + 1));
+        for (nrv::usize j = 0; j < m; j++) ok = ok && out[j] == popped++;
+    }
+    nrv::u32 value = 0;
+    while (queue.pop(value)) ok = ok && value == popped++;
+    ok = ok && popped == pushed;
+    std::cout << "batch push and pop: " << (ok ? "ok" : "FAIL") << "\n";
+    return ok;
+}
+}  // namespace env
+
+auto main([[maybe_unused]]nrv::i32 argc, [[maybe_unused]]char const* argv[]) -> nrv::i32 {
+    using namespace std::chrono_literals;
+    auto ok = env::batches();
+    ok = env::run<1024>("flat out", 20'000'000, 0ns) && ok;
+    ok = env::run<65536>("paced 1 MHz", 2'000'000, 1000ns) && ok;
+    return ok ? 0 : 1;
+}
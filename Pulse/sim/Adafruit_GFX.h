@@ -0,0 +1,10 @@
+/**
+ * @file   Adafruit_GFX.h
+ * @author Pratchaya Khansomboon (pratchaya.k.git@gmail.com)
+ * @brief  The drawing the Pulse firmware uses is in Adafruit_SSD1306.h, the
+ *         include has to resolve in the simulator.
+ * @date   2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+#pragma once
@@ -0,0 +1,67 @@
+/**
+ * @file   Adafruit_SSD1306.h
+ * @author Pratchaya Khansomboon (pratchaya.k.git@gmail.com)
+ * @brief  SSD1306 OLED driving the simulator's framebuffer instead of the
+ *         I2C bus.
+ * @date   2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+#pragma once
+#include <cstdint>
+#include <cstdarg>
+
+#include "Arduino.h"
+#include "Adafruit_GFX.h"
+#include "Wire.h"
+#include "sim.hpp"
+
+constexpr std::uint8_t SSD1306_SWITCHCAPVCC = 0x02;
+constexpr std::uint16_t SSD1306_BLACK = 0;
+constexpr std::uint16_t SSD1306_WHITE = 1;
+
+namespace sim {
+// Size of the simulated panel, the largest the SSD1306 drives
+constexpr usize SCREEN_WIDTH  = 128;
+constexpr usize SCREEN_HEIGHT = 64;
+
+inline framebuffer<SCREEN_WIDTH, SCREEN_HEIGHT> screen{};
+}  // namespace sim
+
+class Adafruit_SSD1306 {
+  public:
+    Adafruit_SSD1306(std::uint8_t width, std::uint8_t height, [[maybe_unused]] TwoWire* wire)
+        : m_width(width), m_height(height) {}
+
+    auto begin([[maybe_unused]] std::uint8_t vcc, [[maybe_unused]] std::uint8_t address) -> bool {
+        if (m_width > sim::SCREEN_WIDTH || m_height > sim::SCREEN_HEIGHT) return false;
+        sim::screen.width  = m_width;
+        sim::screen.height = m_height;
+        return true;
+    }
+    auto width() const -> std::int16_t { return std::int16_t(m_width); }
+    auto height() const -> std::int16_t { return std::int16_t(m_height); }
+
+    auto clearDisplay() -> void { sim::screen.clear(); }
+    auto drawPixel(std::int16_t x, std::int16_t y, std::uint16_t color) -> void {
+        sim::screen.draw(x, y, color);
+    }
+    auto display() -> void { sim::screen.show(); }
+
+    // The text is kept as is, not rasterised
+    auto setCursor([[maybe_unused]] std::int16_t x, [[maybe_unused]] std::int16_t y) -> void {}
+    auto setTextSize([[maybe_unused]] std::uint8_t size) -> void {}
+    auto setTextColor([[maybe_unused]] std::uint16_t color) -> void {}
+    auto printf(char const* format, ...) -> std::size_t {
+        std::va_list args;
+        va_start(args, format);
+        auto const text = sim::format(format, args);
+        va_end(args);
+        sim::screen.text += text;
+        return text.size();
+    }
+
+  private:
+    sim::usize m_width  = 0;
+    sim::usize m_height = 0;
+};
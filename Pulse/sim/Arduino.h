@@ -0,0 +1,117 @@
+/**
+ * @file   Arduino.h
+ * @author Pratchaya Khansomboon (pratchaya.k.git@gmail.com)
+ * @brief  The Arduino ESP32 core and FreeRTOS calls the Pulse firmware uses,
+ *         on the simulator's virtual clock, timer, tasks, ADC and serial.
+ * @date   2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cstdarg>
+#include <cstdio>
+
+#include <string>
+
+#include "sim.hpp"
+
+#define IRAM_ATTR
+
+// Pins and modes of the ESP32, the pins only need to exist
+constexpr std::uint8_t A2 = 34;
+constexpr std::uint8_t INPUT  = 0x01;
+constexpr std::uint8_t OUTPUT = 0x03;
+enum adc_attenuation_t { ADC_0db, ADC_2_5db, ADC_6db, ADC_11db };
+
+inline auto pinMode([[maybe_unused]] std::uint8_t pin, [[maybe_unused]] std::uint8_t mode) -> void {}
+inline auto digitalWrite([[maybe_unused]] std::uint8_t pin, [[maybe_unused]] std::uint8_t value) -> void {}
+inline auto analogSetAttenuation([[maybe_unused]] adc_attenuation_t attenuation) -> void {}
+// The next reading of the recording
+inline auto analogRead([[maybe_unused]] std::uint8_t pin) -> std::uint16_t { return sim::adc.read(); }
+
+// Microseconds on the virtual clock
+inline auto esp_timer_get_time() -> std::int64_t { return sim::now_us; }
+
+// Hardware timer, the simulator raises its interrupt
+struct hw_timer_t {
+    sim::timer_state* state = nullptr;
+};
+
+inline auto timerBegin(std::uint32_t frequency) -> hw_timer_t* {
+    static hw_timer_t timer{&sim::timer};
+    sim::timer.frequency = frequency;
+    return &timer;
+}
+inline auto timerAttachInterrupt(hw_timer_t* timer, void (*callback)()) -> void { timer->state->callback = callback; }
+inline auto timerAlarm(hw_timer_t* timer, std::uint64_t alarm, bool autoreload,
+                       [[maybe_unused]] std::uint64_t reload_count) -> void {
+    timer->state->alarm  = alarm;
+    timer->state->reload = autoreload;
+}
+
+// FreeRTOS
+using BaseType_t   = int;
+using UBaseType_t  = unsigned int;
+using TickType_t   = std::uint32_t;
+using TaskHandle_t = sim::task_state*;
+
+constexpr BaseType_t pdFALSE = 0;
+constexpr BaseType_t pdTRUE  = 1;
+constexpr BaseType_t pdPASS  = 1;
+constexpr TickType_t portMAX_DELAY = 0xffffffff;
+constexpr UBaseType_t configMAX_PRIORITIES = 25;
+#define portYIELD_FROM_ISR(woken) ((void)(woken))
+
+inline auto xTaskCreatePinnedToCore(void (*entry)(void*), [[maybe_unused]] char const* name, std::uint32_t stack_depth,
+                                    void* parameter, [[maybe_unused]] UBaseType_t priority, TaskHandle_t* handle,
+                                    [[maybe_unused]] BaseType_t core) -> BaseType_t {
+    auto* const task = sim::create_task(entry, parameter, stack_depth);
+    if (handle != nullptr) *handle = task;
+    return pdPASS;
+}
+inline auto vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t* woken) -> void {
+    task->notifications++;
+    if (woken != nullptr) *woken = pdTRUE;
+}
+inline auto ulTaskNotifyTake(BaseType_t clear, [[maybe_unused]] TickType_t wait) -> std::uint32_t {
+    return sim::take_notification(clear != pdFALSE);
+}
+
+// Serial port, into sim::serial
+namespace sim {
+inline auto format(char const* format, std::va_list args) -> std::string {
+    std::va_list copy;
+    va_copy(copy, args);
+    auto const length = std::vsnprintf(nullptr, 0, format, copy);
+    va_end(copy);
+    if (length <= 0) return {};
+    std::string text(usize(length) + 1, '\0');
+    std::vsnprintf(text.data(), text.size(), format, args);
+    text.pop_back();
+    return text;
+}
+}  // namespace sim
+
+class HardwareSerial {
+  public:
+    auto begin([[maybe_unused]] unsigned long baud) -> void {}
+    auto print(char const* text) -> std::size_t { return write(text); }
+    auto println(char const* text) -> std::size_t { return write(std::string(text) + "\n"); }
+    // No format attribute, the firmware's %lld is an i64 on the ESP32
+    auto printf(char const* format, ...) -> std::size_t {
+        std::va_list args;
+        va_start(args, format);
+        auto const text = sim::format(format, args);
+        va_end(args);
+        return write(text);
+    }
+
+  private:
+    auto write(std::string const& text) -> std::size_t {
+        sim::serial.write(text);
+        return text.size();
+    }
+};
+inline HardwareSerial Serial{};
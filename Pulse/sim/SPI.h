@@ -0,0 +1,10 @@
+/**
+ * @file   SPI.h
+ * @author Pratchaya Khansomboon (pratchaya.k.git@gmail.com)
+ * @brief  Nothing of SPI is used by the Pulse firmware, the include has to
+ *         resolve in the simulator.
+ * @date   2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+#pragma once
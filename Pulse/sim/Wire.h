@@ -0,0 +1,12 @@
+/**
+ * @file   Wire.h
+ * @author Pratchaya Khansomboon (pratchaya.k.git@gmail.com)
+ * @brief  I2C bus of the display, a handle only in the simulator.
+ * @date   2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+#pragma once
+
+class TwoWire {};
+inline TwoWire Wire{};
@@ -0,0 +1,18 @@
+#!/usr/bin/env sh
+
+set -e
+
+bin="bin"
+
+cpp_version=-std=c++20
+warnings="-Wall -Wextra -Wconversion -Wpedantic -Werror -Wno-missing-field-initializers"
+optimisation="-O2"
+# The firmware's own includes before its headers, Arduino.h and the others
+# resolve to the simulator's here
+include_dir="-I. -I../src"
+compile_flags="${cpp_version} ${warnings} ${optimisation} ${include_dir}"
+
+mkdir -p ${bin}
+
+# compile, the firmware is part of the translation unit
+c++ ${compile_flags} sim.cpp -o ${bin}/sim
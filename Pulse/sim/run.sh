@@ -0,0 +1,4 @@
+#!/usr/bin/env sh
+
+./build.sh
+./bin/sim "$@"
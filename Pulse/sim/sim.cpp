@@ -0,0 +1,182 @@
+/**
+ * @file   sim.cpp
+ * @author Pratchaya Khansomboon (pratchaya.k.git@gmail.com)
+ * @brief  Runs the unmodified Pulse firmware on the host, replaying a
+ *         recording of ADC readings as fast as it can be processed.
+ *
+ *         sim <readings> [options]
+ *         sim --synthetic <bpm> <minutes> [options]
+ *
+ *         --repeat <n>     replay the readings n times
+ *         --batch <n>      timer ticks between calls of loop(), 1 to 256
+ *         --serial <file>  write the serial output to file
+ *         --screen <file>  write the last frame displayed as a PBM image
+ *
+ *         One reading per timer tick and line, the last integer on the
+ *         line: a plain list or a CSV with the readings in the last column.
+ * @date   2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+// The firmware builds without -Wconversion, it passes i32 coordinates to
+// the int16_t of the Adafruit drawing API
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wconversion"
+#include "main.cpp"
+#pragma GCC diagnostic pop
+
+#include <iostream>
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <chrono>
+#include <random>
+
+namespace env {
+struct options {
+    std::string readings{};
+    nrv::f64 bpm       = 0.0;
+    nrv::f64 minutes   = 0.0;
+    nrv::usize repeat  = 1;
+    nrv::usize batch   = 16;
+    std::string serial{};
+    std::string screen{};
+};
+
+auto usage() -> void {
+    std::cerr << "usage: sim <readings> [options]\n"
+                 "       sim --synthetic <bpm> <minutes> [options]\n"
+                 "  --repeat <n>     replay the readings n times\n"
+                 "  --batch <n>      timer ticks between calls of loop(), 1 to 256\n"
+                 "  --serial <file>  write the serial output to file\n"
+                 "  --screen <file>  write the last frame displayed as a PBM image\n";
+}
+
+auto parse(nrv::i32 argc, char const* argv[]) -> options {
+    options o{};
+    auto const arg = [&](nrv::i32& i) -> std::string {
+        if (++i >= argc) throw std::invalid_argument(std::string("sim: ") + argv[i - 1] + " needs a value");
+        return argv[i];
+    };
+    for (nrv::i32 i = 1; i < argc; i++) {
+        std::string const a = argv[i];
+        if (a == "--synthetic") {
+            o.bpm     = std::stod(arg(i));
+            o.minutes = std::stod(arg(i));
+        } else if (a == "--repeat") {
+            o.repeat = std::stoul(arg(i));
+        } else if (a == "--batch") {
+            o.batch = std::stoul(arg(i));
+        } else if (a == "--serial") {
+            o.serial = arg(i);
+        } else if (a == "--screen") {
+            o.screen = arg(i);
+        } else if (a.starts_with("--")) {
+            throw std::invalid_argument("sim: unknown option " + a);
+        } else {
+            o.readings = a;
+        }
+    }
+    if (o.readings.empty() == (o.minutes <= 0.0))
+        throw std::invalid_argument("sim: give either a readings file or --synthetic");
+    if (o.repeat == 0 || o.batch == 0 || o.batch > sample_queue.capacity())
+        throw std::invalid_argument("sim: --repeat has to be at least 1 and --batch 1 to 256");
+    return o;
+}
+
+/**
+ * Pulse sensor readings at the firmware's sample rate like the heart_rate
+ * model: a systolic and a diastolic wave every beat, beat intervals varying
+ * by 3 % around 60 / bpm, breathing wander and noise.
+ */
+auto pulse(nrv::f64 const& bpm, nrv::f64 const& minutes) -> std::vector<nrv::u16> {
+    constexpr auto fs = nrv::f64(TIMER_FREQUENCY);
+    std::mt19937 rng{0};
+    std::normal_distribution<nrv::f64> variation(0.0, 0.03);
+    std::normal_distribution<nrv::f64> noise(0.0, 15.0);
+    auto const count = nrv::usize(minutes * 60.0 * fs);
+    std::vector<nrv::f64> x(count);
+    for (nrv::usize n = 0; n < count; n++) {
+        auto const t = nrv::f64(n) / fs;
+        x[n] = 2000.0 + 150.0 * std::sin(2.0 * M_PI * 0.25 * t) + noise(rng);
+    }
+    if (bpm > 0.0) {
+        for (auto beat = 0.5; beat < minutes * 60.0; beat += 60.0 / bpm * (1.0 + variation(rng))) {
+            auto const begin = nrv::usize(std::max(0.0, (beat - 0.5) * fs));
+            auto const end = std::min(count, nrv::usize((beat + 1.0) * fs));
+            for (nrv::usize n = begin; n < end; n++) {
+                auto const t = nrv::f64(n) / fs - beat;
+                x[n] += 300.0 * std::exp(-0.5 * std::pow((t - 0.12) / 0.05, 2.0))
+                      + 120.0 * std::exp(-0.5 * std::pow((t - 0.35) / 0.07, 2.0));
+            }
+        }
+    }
+    std::vector<nrv::u16> readings(count);
+    std::transform(std::begin(x), std::end(x), std::begin(readings),
+                   [](nrv::f64 const& v) { return nrv::u16(std::round(std::clamp(v, 0.0, 4095.0))); });
+    return readings;
+}
+
+/**
+ * setup(), then batch timer ticks at a time: the interrupt notifies the
+ * sampling task, which reads the ADC and queues the sample, and loop()
+ * drains the queue. With loop() always keeping up nothing is dropped, the
+ * output only depends on the readings and the batch size.
+ */
+auto run(options const& o) -> bool {
+    sim::adc.readings = o.readings.empty() ? pulse(o.bpm, o.minutes) : sim::load_readings(o.readings);
+    sim::adc.loops = o.repeat;
+    if (sim::adc.readings.empty()) throw std::runtime_error("sim: no readings in " + o.readings);
+    std::FILE* serial = nullptr;
+    if (!o.serial.empty()) {
+        serial = std::fopen(o.serial.c_str(), "wb");
+        if (serial == nullptr) throw std::runtime_error("sim: can't open " + o.serial);
+        sim::serial.file = serial;
+    }
+
+    auto const start = std::chrono::steady_clock::now();
+    setup();
+    if (!sim::timer.running()) throw std::logic_error("sim: setup() didn't start the sampling timer");
+    while (!sim::adc.done()) {
+        for (nrv::usize i = 0; i < o.batch && !sim::adc.done(); i++) sim::tick();
+        while (!sample_queue.empty()) loop();
+    }
+    auto const seconds = std::chrono::duration<nrv::f64>(std::chrono::steady_clock::now() - start).count();
+
+    if (serial != nullptr) std::fclose(serial);
+    if (!o.screen.empty()) sim::screen.save(o.screen);
+
+    auto const samples = sim::adc.next;
+    auto const simulated = nrv::f64(sim::now_us) / 1e6;
+    auto const dropped = dropped_samples.load(std::memory_order_relaxed);
+    std::cout << samples << " samples, " << simulated / 3600.0 << " h simulated in " << seconds << " s: "
+              << nrv::f64(samples) / seconds << " samples/s, " << simulated / seconds << "x real time\n"
+              << sim::screen.frames << " frames displayed, last \"" << sim::screen.shown_text << "\"\n"
+              << sim::serial.lines << " serial lines, last \"" << sim::serial.last_line << "\"\n"
+              << dropped << " samples dropped\n";
+
+    // Synthetic readings have a known rate to check the estimate against
+    auto ok = dropped == 0;
+    if (o.readings.empty()) {
+        auto const found = bpm_estimate.confidence >= MIN_CONFIDENCE;
+        auto const error = std::abs(nrv::f64(bpm_estimate.bpm) - o.bpm);
+        auto const expected = o.bpm > 0.0 ? found && error < 3.0 : !found;
+        std::cout << "estimate " << bpm_estimate.bpm << " BPM at " << o.bpm << " BPM "
+                  << (expected ? "ok" : "FAIL") << "\n";
+        ok = ok && expected;
+    }
+    return ok;
+}
+}  // namespace env
+
+auto main(nrv::i32 argc, char const* argv[]) -> nrv::i32 {
+    try {
+        return env::run(env::parse(argc, argv)) ? 0 : 1;
+    } catch (std::exception const& e) {
+        std::cerr << e.what() << "\n";
+        env::usage();
+        return 2;
+    }
+}
@@ -0,0 +1,228 @@
+/**
+ * @file   sim.hpp
+ * @author Pratchaya Khansomboon (pratchaya.k.git@gmail.com)
+ * @brief  Host backend of the Pulse firmware: a virtual clock, a timer
+ *         interrupt, FreeRTOS tasks, an ADC replaying a recording, a serial
+ *         port and a display framebuffer. The Arduino headers next to it
+ *         map the firmware's calls onto it.
+ * @date   2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifndef __linux__
+#error "the Pulse simulator switches tasks with ucontext, it's for the Linux host"
+#endif
+#include <ucontext.h>
+
+#include "types.hpp"
+
+namespace sim {
+using nrv::i64;
+using nrv::u16;
+using nrv::u32;
+using nrv::u64;
+using nrv::usize;
+
+// Virtual time in microseconds, only the simulator moves it
+inline i64 now_us = 0;
+
+/**
+ * ADC replaying a recording, one reading per conversion whatever the pin.
+ * The recording is read up front and replayed `loops` times, so an
+ * hour-long run doesn't wait on the file.
+ */
+struct adc_state {
+    std::vector<u16> readings{};
+    usize loops = 1;
+    usize next  = 0;  // conversions so far
+
+    auto total() const -> usize { return readings.size() * loops; }
+    auto done() const -> bool { return next >= total(); }
+    auto read() -> u16 {
+        if (readings.empty()) return 0;
+        auto const value = readings[next % readings.size()];
+        next++;
+        return value;
+    }
+};
+inline adc_state adc{};
+
+/**
+ * One reading per line, the last integer on it, so a plain list and a CSV
+ * with the reading in the last column both work. Lines without a number,
+ * a header, are skipped. Clamped to the 12 bits of the ESP32 ADC.
+ */
+inline auto load_readings(std::string const& path) -> std::vector<u16> {
+    std::ifstream file{path, std::ios::binary};
+    if (!file)
+        throw std::runtime_error("sim: can't open " + path);
+    std::vector<u16> readings{};
+    std::string line{};
+    while (std::getline(file, line)) {
+        auto const last = line.find_last_of("0123456789");
+        if (last == std::string::npos) continue;
+        auto const first = line.find_last_not_of("0123456789", last);
+        auto const begin = first == std::string::npos ? 0 : first + 1;
+        u32 value = 0;
+        std::from_chars(line.data() + begin, line.data() + last + 1, value);
+        readings.push_back(u16(value > 4095 ? 4095 : value));
+    }
+    return readings;
+}
+
+// The serial port, lines are counted and optionally written to a file
+struct serial_state {
+    std::FILE* file = nullptr;
+    usize lines = 0;
+    std::string last_line{};
+    std::string pending{};
+
+    auto write(std::string const& text) -> void {
+        if (file != nullptr) std::fwrite(text.data(), 1, text.size(), file);
+        pending += text;
+        for (auto end = pending.find('\n'); end != std::string::npos; end = pending.find('\n')) {
+            last_line = pending.substr(0, end);
+            pending.erase(0, end + 1);
+            lines++;
+        }
+    }
+};
+inline serial_state serial{};
+
+// One hardware timer, its alarm raises the interrupt every period
+struct timer_state {
+    u32 frequency = 0;  // ticks per second
+    u64 alarm     = 0;  // ticks per interrupt
+    bool reload   = false;
+    void (*callback)() = nullptr;
+
+    auto period_us() const -> i64 { return i64(alarm * 1'000'000 / frequency); }
+    auto running() const -> bool { return callback != nullptr && alarm > 0 && frequency > 0; }
+};
+inline timer_state timer{};
+
+/**
+ * A FreeRTOS task as a coroutine on its own stack. A task runs until it
+ * waits for a notification it doesn't have, then control goes back to the
+ * simulator, which resumes it once an interrupt notified it. The
+ * priorities and cores don't matter, every task runs to its next wait
+ * right after the interrupt, like the highest priority task on a core of
+ * its own.
+ */
+struct task_state {
+    void (*entry)(void*) = nullptr;
+    void* parameter      = nullptr;
+    u32 notifications    = 0;
+    bool waiting         = false;
+    std::vector<char> stack{};
+    ucontext_t context{};
+};
+inline std::vector<std::unique_ptr<task_state>> tasks{};
+inline ucontext_t scheduler_context{};
+inline task_state* running_task = nullptr;
+
+inline auto task_trampoline() -> void {
+    running_task->entry(running_task->parameter);
+    // A FreeRTOS task never returns, one that does is parked
+    running_task->waiting = true;
+    swapcontext(&running_task->context, &scheduler_context);
+}
+
+inline auto create_task(void (*entry)(void*), void* parameter, usize const& stack_size) -> task_state* {
+    auto task = std::make_unique<task_state>();
+    task->entry     = entry;
+    task->parameter = parameter;
+    // Room for the host's deeper library calls
+    task->stack.resize(std::max<usize>(stack_size, 64 * 1024));
+    getcontext(&task->context);
+    task->context.uc_stack.ss_sp   = task->stack.data();
+    task->context.uc_stack.ss_size = task->stack.size();
+    task->context.uc_link          = &scheduler_context;
+    makecontext(&task->context, task_trampoline, 0);
+    tasks.push_back(std::move(task));
+    return tasks.back().get();
+}
+
+// Runs every task that has something to do until all of them wait
+inline auto run_tasks() -> void {
+    for (auto const& task : tasks) {
+        if (task->waiting && task->notifications == 0) continue;
+        running_task = task.get();
+        task->waiting = false;
+        swapcontext(&scheduler_context, &task->context);
+        running_task = nullptr;
+    }
+}
+
+// ulTaskNotifyTake of the running task
+inline auto take_notification(bool const& clear) -> u32 {
+    auto* const task = running_task;
+    if (task == nullptr)
+        throw std::logic_error("sim: a notification can only be taken by a task");
+    while (task->notifications == 0) {
+        task->waiting = true;
+        swapcontext(&task->context, &scheduler_context);
+    }
+    auto const value = task->notifications;
+    task->notifications = clear ? 0 : value - 1;
+    return value;
+}
+
+// The timer interrupt at the next alarm and the tasks it wakes
+inline auto tick() -> void {
+    now_us += timer.period_us();
+    timer.callback();
+    run_tasks();
+}
+
+// Monochrome framebuffer of the SSD1306, what display() last showed. Up to
+// W by H, begin() sets the size of the panel
+template <usize W, usize H>
+struct framebuffer {
+    usize width  = W;
+    usize height = H;
+    std::array<u16, W * H> pixels{};
+    std::array<u16, W * H> shown{};
+    std::string text{};
+    std::string shown_text{};
+    usize frames = 0;
+
+    auto clear() -> void {
+        pixels.fill(0);
+        text.clear();
+    }
+    auto draw(nrv::i32 const& x, nrv::i32 const& y, u16 const& color) -> void {
+        if (x < 0 || y < 0 || usize(x) >= width || usize(y) >= height) return;
+        pixels[usize(y) * W + usize(x)] = color;
+    }
+    auto show() -> void {
+        shown = pixels;
+        shown_text = text;
+        frames++;
+    }
+
+    // Plain PBM image of the shown frame
+    auto save(std::string const& path) const -> void {
+        std::ofstream file{path, std::ios::binary};
+        file << "P1\n" << width << " " << height << "\n";
+        for (usize y = 0; y < height; y++) {
+            for (usize x = 0; x < width; x++) file << (shown[y * W + x] != 0 ? '1' : '0');
+            file << "\n";
+        }
+    }
+};
+}  // namespace sim
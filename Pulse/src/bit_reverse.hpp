@@ -0,0 +1,183 @@
+/**
+ * @file   bit_reverse.hpp
+ * @author Pratchaya Khansomboon (pratchaya.k.git@gmail.com)
+ * @brief  Bit reversal of indices and bit reversal permutation of power of 2
+ *         sized buffers, table driven and cache blocked.
+ * @date   2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "types.hpp"
+
+namespace nrv {
+namespace detail {
+// Every byte with its bits reversed, generated at compile time
+inline constexpr auto bit_reverse_table = [] {
+    std::array<u8, 256> table{};
+    for (usize i = 0; i < 256; i++) {
+        usize r = 0;
+        for (usize b = 0; b < 8; b++) r |= ((i >> b) & 1) << (7 - b);
+        table[i] = u8(r);
+    }
+    return table;
+}();
+
+// Scratch tile for the blocked permutations, one per thread and type
+template <typename T>
+auto bit_reverse_tile(usize const& size) -> T* {
+    thread_local std::vector<T> tile{};
+    if (tile.size() < size) tile.resize(size);
+    return tile.data();
+}
+}  // namespace detail
+
+// The lowest `bits` bits of value in reverse order, a table lookup per byte
+constexpr auto reverse_bits(usize value, usize const& bits) -> usize {
+    auto const bytes = (bits + 7) / 8;
+    usize r = 0;
+    for (usize i = 0; i < bytes; i++, value >>= 8)
+        r = (r << 8) | detail::bit_reverse_table[value & 0xFF];
+    return r >> (bytes * 8 - bits);
+}
+
+/**
+ * Blocking of the bit reversal permutation for values of type T. An index of
+ * n bits is split as [a | m | c], with q bits in a and c and the b = n - 2q
+ * middle bits in m. Its reversal is [rev(c) | rev(m) | rev(a)], so all the
+ * 2^q x 2^q values with middle m move to middle rev(m) as a transposed tile.
+ * The tile is read and written one row of 2^q consecutive values at a time
+ * (COBRA, Carter and Gatlin), instead of scattering single values over the
+ * whole buffer. q is at most max_q, a tile of about 16 KiB, and at most n / 2,
+ * so small buffers are a single tile or a few and are permuted without the
+ * unpredictable branch of swapping pairs.
+ */
+template <typename T>
+struct bit_reverse_blocking {
+    static constexpr usize max_q = std::max<usize>(2, usize(std::bit_width(16384 / sizeof(T) + 1) - 1) / 2);
+
+    static constexpr auto q(usize const& size) -> usize {
+        return std::min(max_q, usize(std::countr_zero(size)) / 2);
+    }
+
+    // Number of middle values, the independent units of work
+    static constexpr auto blocks(usize const& size) -> usize {
+        return usize{1} << (usize(std::countr_zero(size)) - 2 * q(size));
+    }
+};
+
+namespace detail {
+// Copy the tile with middle m into buffer[rev(a)][c]
+template <typename T>
+auto bit_reverse_gather(T const* data, T* buffer, usize const& m, usize const& b, usize const& q) -> void {
+    auto const Q = usize{1} << q;
+    for (usize a = 0; a < Q; a++) {
+        auto const* row = data + ((a << (b + q)) | (m << q));
+        std::copy_n(row, Q, buffer + reverse_bits(a, q) * Q);
+    }
+}
+
+// Write buffer[a][c] to [rev(c) | mr | a]
+template <typename T>
+auto bit_reverse_scatter(T const* buffer, T* data, usize const& mr, usize const& b, usize const& q) -> void {
+    auto const Q = usize{1} << q;
+    for (usize c = 0; c < Q; c++) {
+        auto* row = data + ((reverse_bits(c, q) << (b + q)) | (mr << q));
+        for (usize a = 0; a < Q; a++) row[a] = buffer[a * Q + c];
+    }
+}
+
+inline auto check_bit_reverse_size(usize const& size) -> void {
+    if (!std::has_single_bit(size))
+        throw std::invalid_argument("bit_reverse: size needs to be a power of 2");
+}
+}  // namespace detail
+
+/**
+ * In-place permutation of the middle values [first, last) of the blocking, a
+ * range of independent work for splitting a large permutation between
+ * threads. Every middle m is swapped with rev(m) by the smaller one of the
+ * two, so the ranges can be any partition of [0, blocks(size)).
+ */
+template <typename T>
+auto bit_reverse_permute(std::span<T> data, usize const& first, usize const& last) -> void {
+    using blocking = bit_reverse_blocking<T>;
+    auto const q = blocking::q(data.size());
+    auto const b = usize(std::countr_zero(data.size())) - 2 * q;
+    auto const tile = usize{1} << (2 * q);
+    auto* lo = detail::bit_reverse_tile<T>(2 * tile);
+    auto* hi = lo + tile;
+    for (usize m = first; m < last; m++) {
+        auto const mr = reverse_bits(m, b);
+        if (mr < m) continue;
+        detail::bit_reverse_gather(data.data(), lo, m, b, q);
+        if (mr != m) detail::bit_reverse_gather(data.data(), hi, mr, b, q);
+        detail::bit_reverse_scatter(lo, data.data(), mr, b, q);
+        if (mr != m) detail::bit_reverse_scatter(hi, data.data(), m, b, q);
+    }
+}
+
+/**
+ * Index pairs (i, rev(i)) with i < rev(i) for a power of 2 size. Swapping the
+ * pairs is the in-place permutation, the fastest one for small buffers where
+ * keeping the list is cheap and all the work is done up front.
+ */
+inline auto bit_reverse_pairs(usize const& size) -> std::vector<std::pair<usize, usize>> {
+    detail::check_bit_reverse_size(size);
+    auto const bits = usize(std::countr_zero(size));
+    std::vector<std::pair<usize, usize>> pairs{};
+    pairs.reserve(size / 2);
+    for (usize i = 0; i < size; i++) {
+        auto const r = reverse_bits(i, bits);
+        if (i < r) pairs.emplace_back(i, r);
+    }
+    return pairs;
+}
+
+template <typename T>
+auto bit_reverse_permute(std::span<T> data, std::span<std::pair<usize, usize> const> pairs) -> void {
+    for (auto const& [i, r] : pairs) std::swap(data[i], data[r]);
+}
+
+// In-place bit reversal permutation, data.size() a power of 2
+template <typename T>
+auto bit_reverse_permute(std::span<T> data) -> void {
+    detail::check_bit_reverse_size(data.size());
+    if (data.size() < 4) return;  // 0 and 1 bit indices are their own reversal
+    bit_reverse_permute(data, 0, bit_reverse_blocking<T>::blocks(data.size()));
+}
+
+// Out-of-place bit reversal permutation, out[rev(i)] = in[i]. The buffers
+// must not overlap.
+template <typename T>
+auto bit_reverse_copy(std::span<T const> in, std::span<T> out) -> void {
+    auto const N = in.size();
+    detail::check_bit_reverse_size(N);
+    if (out.size() != N)
+        throw std::invalid_argument("bit_reverse: buffer sizes don't match");
+    if (N < 4) {
+        std::copy_n(in.data(), N, out.data());
+        return;
+    }
+
+    using blocking = bit_reverse_blocking<T>;
+    auto const q = blocking::q(N);
+    auto const b = usize(std::countr_zero(N)) - 2 * q;
+    auto* tile = detail::bit_reverse_tile<T>(usize{1} << (2 * q));
+    for (usize m = 0; m < blocking::blocks(N); m++) {
+        detail::bit_reverse_gather(in.data(), tile, m, b, q);
+        detail::bit_reverse_scatter(tile, out.data(), reverse_bits(m, b), b, q);
+    }
+}
+}  // namespace nrv
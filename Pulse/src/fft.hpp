@@ -0,0 +1,465 @@
+/**
+ * @file   fft.hpp
+ * @author Pratchaya Khansomboon (pratchaya.k.git@gmail.com)
+ * @brief  Iterative FFT with a reusable plan. The plan holds the twiddle
+ *         factors and the input permutation for one size, so they're computed
+ *         once and shared by every transform of that size. Power of 2 sizes
+ *         use radix-2, other sizes mixed radix-2/3/4/5 or Bluestein.
+ * @date   2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+
+#include <algorithm>
+#include <bit>
+#include <complex>
+#include <memory>
+#include <numbers>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "types.hpp"
+#include "bit_reverse.hpp"
+#include "fft_simd.hpp"
+
+namespace nrv {
+namespace detail {
+// std::complex multiplication checks for NaN and infinities (Annex G), which
+// prevents the butterflies from being inlined. The twiddles are always finite.
+template <typename T>
+constexpr auto cmul(std::complex<T> const& a, std::complex<T> const& b) -> std::complex<T> {
+    return {a.real() * b.real() - a.imag() * b.imag(),
+            a.real() * b.imag() + a.imag() * b.real()};
+}
+
+// Transforms on a thread pool and batches, fft_parallel.hpp
+template <typename T>
+struct fft_parallel;
+}  // namespace detail
+
+// Algorithm a plan picked for its size
+enum class fft_algorithm {
+    radix2,       // N = 2^n, in-place bit reversal and radix-2 butterflies
+    mixed_radix,  // N = 2^a * 3^b * 5^c, radix-2/3/4/5 butterflies
+    bluestein,    // any other N, chirp-z as a convolution of power of 2 FFTs
+};
+
+/**
+ * FFT plan for a fixed size N. Construction does all the work that `fft_i`
+ * repeats on every call, executing a plan only runs the butterflies.
+ *
+ * For N = 2^n the plan holds:
+ *
+ *   - The twiddle factors e^(-i*pi*n/m) for every stage. Stage m (half the
+ *     butterfly span) uses m consecutive factors stored at offset m - 1, so the
+ *     whole table is N - 1 entries and is read linearly by the inner loop.
+ *   - The bit reversal permutation as a list of index pairs to swap, for N up
+ *     to swap_limit. Larger transforms are permuted by bit_reverse.hpp a cache
+ *     sized tile at a time, in-place or while copying the input.
+ *
+ * The radix-2 butterflies run on the widest vector instructions the CPU has,
+ * see fft_simd.hpp.
+ *
+ * When N only has the prime factors 2, 3 and 5 the same decimation in time is
+ * done with mixed radices. The bit reversal becomes a digit reversal in the
+ * mixed radix number system and every stage combines p sub-transforms with a
+ * radix-p butterfly, using radix-4 wherever two factors of 2 are available.
+ *
+ * Any other N, e.g. a prime, goes through Bluestein's algorithm. With
+ * nk = (n^2 + k^2 - (k - n)^2) / 2 the DFT is rewritten as a convolution with
+ * the chirp e^(i*pi*n^2/N), which is done with power of 2 FFTs of size
+ * M >= 2N - 1. The chirp and the spectrum of the convolution kernel are
+ * precomputed, so it's still O(N log N).
+ *
+ * A plan is immutable after construction and can be shared between threads.
+ * Executing a plan with scratch never allocates, the caller owns the input,
+ * the output and the scratch buffer. scratch_size() tells how much scratch a
+ * transform needs: none for radix-2, N for an in-place mixed radix transform
+ * and M for Bluestein, a smaller scratch throws. The overloads without scratch
+ * allocate scratch_size() values for that call, radix-2 plans never allocate.
+ *
+ * Transforms on the threads of a thread_pool and batches of signals are in
+ * fft_parallel.hpp, this header doesn't depend on threads so the firmware
+ * can use it.
+ */
+template <typename T>
+class fft_plan {
+  public:
+    using value_type   = T;
+    using complex_type = std::complex<T>;
+    using vector_type  = std::vector<complex_type>;
+
+    // Largest radix-2 transform that keeps the bit reversal swap pairs
+    static constexpr usize swap_limit = usize{1} << 12;
+
+    explicit fft_plan(usize const& size) : m_size(size) {
+        if (size == 0)
+            throw std::invalid_argument("fft_plan: size needs to be at least 1");
+
+        if (std::has_single_bit(size)) {
+            init_radix2();
+        } else if (auto const radices = factorize(size); !radices.empty()) {
+            init_mixed_radix(radices);
+        } else {
+            init_bluestein();
+        }
+    }
+
+    auto size() const -> usize { return m_size; }
+    auto algorithm() const -> fft_algorithm { return m_algorithm; }
+
+    auto scratch_size() const -> usize {
+        switch (m_algorithm) {
+            case fft_algorithm::radix2:      return 0;
+            case fft_algorithm::mixed_radix: return m_size;
+            case fft_algorithm::bluestein:   return m_inner->size();
+        }
+        return 0;
+    }
+
+    // In-place forward transform, data.size() must equal size()
+    auto execute(std::span<complex_type> data) const -> void {
+        execute(data, data);
+    }
+
+    // Out-of-place forward transform, allocates the scratch if it needs any
+    auto execute(std::span<complex_type const> in, std::span<complex_type> out) const -> void {
+        with_scratch([&](auto const& scratch) { execute(in, out, scratch); });
+    }
+
+    // Out-of-place forward transform, in and out may be the same buffer
+    auto execute(std::span<complex_type const> in, std::span<complex_type> out,
+                 std::span<complex_type> scratch) const -> void {
+        check_size(in.size());
+        check_size(out.size());
+        check_scratch(scratch.size());
+
+        switch (m_algorithm) {
+            case fft_algorithm::radix2:
+                if (m_size <= swap_limit) {
+                    if (in.data() != out.data())
+                        std::copy(std::begin(in), std::end(in), std::begin(out));
+                    bit_reverse_permute(out, std::span(m_swaps));
+                } else if (in.data() != out.data()) {
+                    bit_reverse_copy(in, out);
+                } else {
+                    bit_reverse_permute(out);
+                }
+                radix2_butterflies(out.data());
+                break;
+            case fft_algorithm::mixed_radix: {
+                auto const* src = in.data();
+                if (in.data() == out.data()) {
+                    std::copy(std::begin(in), std::end(in), std::begin(scratch));
+                    src = scratch.data();
+                }
+                for (usize i = 0; i < m_size; i++)
+                    out[m_permutation[i]] = src[i];
+                mixed_radix_stages(out.data());
+                break;
+            }
+            case fft_algorithm::bluestein:
+                bluestein(in, out, scratch);
+                break;
+        }
+    }
+
+    // In-place backward transform. Like the forward transform it's
+    // unnormalised, transforming forward and back scales the data by size().
+    auto inverse(std::span<complex_type> data) const -> void {
+        inverse(data, data);
+    }
+
+    // Out-of-place backward transform, allocates the scratch if it needs any
+    auto inverse(std::span<complex_type const> in, std::span<complex_type> out) const -> void {
+        with_scratch([&](auto const& scratch) { inverse(in, out, scratch); });
+    }
+
+    // Out-of-place backward transform, in and out may be the same buffer
+    auto inverse(std::span<complex_type const> in, std::span<complex_type> out,
+                 std::span<complex_type> scratch) const -> void {
+        check_size(in.size());
+        check_size(out.size());
+        check_scratch(scratch.size());
+        std::transform(std::begin(in), std::end(in), std::begin(out),
+                       [](auto const& v) { return std::conj(v); });
+        execute(out, out, scratch);
+        conjugate(out);
+    }
+
+    // Same interface as fft_i, returns the transformed copy of the samples
+    auto operator()(vector_type const& samples) const -> vector_type {
+        auto out = samples;
+        execute(out);
+        return out;
+    }
+
+    // Memory owned by the plan in bytes
+    auto memory() const -> usize {
+        auto bytes = (m_twiddles.capacity() + m_chirp.capacity() + m_kernel.capacity()) * sizeof(complex_type) +
+                     m_swaps.capacity() * sizeof(std::pair<usize, usize>) +
+                     m_permutation.capacity() * sizeof(usize) +
+                     m_stages.capacity() * sizeof(stage);
+        if (m_inner) bytes += m_inner->memory();
+        return bytes;
+    }
+
+  private:
+    struct stage {
+        usize radix;   // p, sub-transforms combined by this stage
+        usize span;    // m, length of every sub-transform
+        usize offset;  // first twiddle of the stage in m_twiddles
+    };
+
+    // Radices of N in stage order, empty when N has a prime factor above 5
+    static auto factorize(usize n) -> std::vector<usize> {
+        std::vector<usize> radices{};
+        for (usize const p : {4, 2, 3, 5}) {
+            while (n % p == 0) {
+                radices.push_back(p);
+                n /= p;
+            }
+        }
+        if (n != 1) radices.clear();
+        return radices;
+    }
+
+    auto init_radix2() -> void {
+        m_algorithm = fft_algorithm::radix2;
+
+        // Twiddle factors, one table per stage laid out back to back
+        m_twiddles.reserve(m_size > 1 ? m_size - 1 : 0);
+        for (usize m = 1; m < m_size; m <<= 1) {
+            for (usize n = 0; n < m; n++)
+                m_twiddles.push_back(twiddle(f64(n), f64(2 * m)));
+        }
+
+        if (m_size <= swap_limit) m_swaps = bit_reverse_pairs(m_size);
+    }
+
+    auto init_mixed_radix(std::vector<usize> const& radices) -> void {
+        m_algorithm = fft_algorithm::mixed_radix;
+
+        // Stage s combines radices[s] transforms of length m, the product of
+        // the previous radices. Twiddles w_L^(r*j) are stored per j for
+        // r = 1..p-1, so one butterfly reads p - 1 consecutive factors.
+        usize m = 1;
+        for (auto const& p : radices) {
+            auto const L = p * m;
+            m_stages.push_back({p, m, m_twiddles.size()});
+            for (usize j = 0; j < m; j++) {
+                for (usize r = 1; r < p; r++)
+                    m_twiddles.push_back(twiddle(f64(r * j), f64(L)));
+            }
+            m = L;
+        }
+
+        // Digit reversal, the last stage splits on the least significant digit
+        // of the input index and places the sub-transform at r * span.
+        m_permutation.resize(m_size);
+        for (usize i = 0; i < m_size; i++) {
+            usize rest = i;
+            usize pos  = 0;
+            for (auto it = std::rbegin(m_stages); it != std::rend(m_stages); ++it) {
+                pos  += (rest % it->radix) * it->span;
+                rest /= it->radix;
+            }
+            m_permutation[i] = pos;
+        }
+    }
+
+    auto init_bluestein() -> void {
+        m_algorithm = fft_algorithm::bluestein;
+        auto const M = std::bit_ceil(2 * m_size - 1);
+        m_inner = std::make_unique<fft_plan const>(M);
+
+        // Chirp e^(-i*pi*n^2/N), n^2 is reduced modulo 2N first so the angle
+        // stays accurate for large n
+        m_chirp.reserve(m_size);
+        for (usize n = 0; n < m_size; n++)
+            m_chirp.push_back(twiddle(f64((n * n) % (2 * m_size)), f64(2 * m_size)));
+
+        // Spectrum of the kernel conj(chirp) wrapped around for negative n,
+        // scaled by 1/M for the unnormalised inverse transform
+        m_kernel.assign(M, complex_type{});
+        m_kernel[0] = std::conj(m_chirp[0]);
+        for (usize n = 1; n < m_size; n++)
+            m_kernel[n] = m_kernel[M - n] = std::conj(m_chirp[n]);
+        m_inner->execute(m_kernel);
+        for (auto& k : m_kernel) k /= T(M);
+    }
+
+    // e^(-2*pi*i*n/d)
+    static auto twiddle(f64 const& n, f64 const& d) -> complex_type {
+        auto const angle = -2.0 * std::numbers::pi * n / d;
+        return {T(std::cos(angle)), T(std::sin(angle))};
+    }
+
+    auto check_size(usize const& size) const -> void {
+        if (size != m_size)
+            throw std::invalid_argument("fft_plan: data size doesn't match the plan");
+    }
+
+    auto check_scratch(usize const& size) const -> void {
+        if (size < scratch_size())
+            throw std::invalid_argument("fft_plan: scratch buffer is too small");
+    }
+
+    // Calls f with scratch_size() values of scratch, only allocated when
+    // there are any
+    template <typename F>
+    auto with_scratch(F const& f) const -> void {
+        if (scratch_size() == 0) return f(std::span<complex_type>{});
+        vector_type scratch(scratch_size());
+        f(std::span(scratch));
+    }
+
+    // The backward transform is the forward one on the conjugated data:
+    // ifft(x) = conj(fft(conj(x))), so no second twiddle table is needed.
+    static auto conjugate(std::span<complex_type> data) -> void {
+        for (auto& v : data) v = std::conj(v);
+    }
+
+    auto radix2_butterflies(complex_type* data) const -> void {
+        detail::radix2_butterflies(data, m_twiddles.data(), m_size);
+    }
+
+    auto mixed_radix_stages(complex_type* data) const -> void {
+        for (auto const& s : m_stages) {
+            auto const* w = m_twiddles.data() + s.offset;
+            auto const L  = s.radix * s.span;
+            for (usize b = 0; b < m_size; b += L) {
+                switch (s.radix) {
+                    case 2: butterfly2(data + b, w, s.span); break;
+                    case 3: butterfly3(data + b, w, s.span); break;
+                    case 4: butterfly4(data + b, w, s.span); break;
+                    case 5: butterfly5(data + b, w, s.span); break;
+                }
+            }
+        }
+    }
+
+    // -i * z
+    static auto mul_neg_i(complex_type const& z) -> complex_type {
+        return {z.imag(), -z.real()};
+    }
+
+    static auto butterfly2(complex_type* x, complex_type const* w, usize const& m) -> void {
+        for (usize j = 0; j < m; j++, w += 1) {
+            auto const x0 = x[j];
+            auto const x1 = detail::cmul(x[j + m], w[0]);
+            x[j]     = x0 + x1;
+            x[j + m] = x0 - x1;
+        }
+    }
+
+    static auto butterfly3(complex_type* x, complex_type const* w, usize const& m) -> void {
+        constexpr auto s = T(0.86602540378443864676);  // sin(2*pi/3)
+        for (usize j = 0; j < m; j++, w += 2) {
+            auto const x0 = x[j];
+            auto const x1 = detail::cmul(x[j + m],     w[0]);
+            auto const x2 = detail::cmul(x[j + 2 * m], w[1]);
+            auto const t  = x1 + x2;
+            auto const a  = x0 - t * T(0.5);
+            auto const b  = mul_neg_i(x1 - x2) * s;
+            x[j]         = x0 + t;
+            x[j + m]     = a + b;
+            x[j + 2 * m] = a - b;
+        }
+    }
+
+    static auto butterfly4(complex_type* x, complex_type const* w, usize const& m) -> void {
+        for (usize j = 0; j < m; j++, w += 3) {
+            auto const x0 = x[j];
+            auto const x1 = detail::cmul(x[j + m],     w[0]);
+            auto const x2 = detail::cmul(x[j + 2 * m], w[1]);
+            auto const x3 = detail::cmul(x[j + 3 * m], w[2]);
+            auto const a0 = x0 + x2;
+            auto const a1 = x0 - x2;
+            auto const b0 = x1 + x3;
+            auto const b1 = mul_neg_i(x1 - x3);
+            x[j]         = a0 + b0;
+            x[j + m]     = a1 + b1;
+            x[j + 2 * m] = a0 - b0;
+            x[j + 3 * m] = a1 - b1;
+        }
+    }
+
+    static auto butterfly5(complex_type* x, complex_type const* w, usize const& m) -> void {
+        constexpr auto c1 = T( 0.30901699437494742410);  // cos(2*pi/5)
+        constexpr auto c2 = T(-0.80901699437494742410);  // cos(4*pi/5)
+        constexpr auto s1 = T( 0.95105651629515357212);  // sin(2*pi/5)
+        constexpr auto s2 = T( 0.58778525229247312917);  // sin(4*pi/5)
+        for (usize j = 0; j < m; j++, w += 4) {
+            auto const x0 = x[j];
+            auto const x1 = detail::cmul(x[j + m],     w[0]);
+            auto const x2 = detail::cmul(x[j + 2 * m], w[1]);
+            auto const x3 = detail::cmul(x[j + 3 * m], w[2]);
+            auto const x4 = detail::cmul(x[j + 4 * m], w[3]);
+            auto const t1 = x1 + x4;
+            auto const t2 = x2 + x3;
+            auto const d1 = x1 - x4;
+            auto const d2 = x2 - x3;
+            auto const a1 = x0 + t1 * c1 + t2 * c2;
+            auto const a2 = x0 + t1 * c2 + t2 * c1;
+            auto const b1 = mul_neg_i(d1 * s1 + d2 * s2);
+            auto const b2 = mul_neg_i(d1 * s2 - d2 * s1);
+            x[j]         = x0 + t1 + t2;
+            x[j + m]     = a1 + b1;
+            x[j + 2 * m] = a2 + b2;
+            x[j + 3 * m] = a2 - b2;
+            x[j + 4 * m] = a1 - b1;
+        }
+    }
+
+    auto bluestein(std::span<complex_type const> in, std::span<complex_type> out,
+                   std::span<complex_type> scratch) const -> void {
+        bluestein(in, out, scratch, [this](auto const& a, bool const& backward) {
+            if (backward) m_inner->inverse(a);
+            else          m_inner->execute(a);
+        });
+    }
+
+    // Chirp-z with the inner transforms done by transform(a, backward), the
+    // pool runs them in parallel
+    template <typename F>
+    auto bluestein(std::span<complex_type const> in, std::span<complex_type> out,
+                   std::span<complex_type> scratch, F const& transform) const -> void {
+        auto const a = scratch.first(m_inner->size());
+        for (usize n = 0; n < m_size; n++)
+            a[n] = detail::cmul(in[n], m_chirp[n]);
+        std::fill(std::begin(a) + isize(m_size), std::end(a), complex_type{});
+
+        transform(a, false);
+        for (usize k = 0; k < a.size(); k++)
+            a[k] = detail::cmul(a[k], m_kernel[k]);
+        transform(a, true);
+
+        for (usize k = 0; k < m_size; k++)
+            out[k] = detail::cmul(a[k], m_chirp[k]);
+    }
+
+    friend struct detail::fft_parallel<T>;
+
+  private:
+    usize m_size = 0;
+    fft_algorithm m_algorithm = fft_algorithm::radix2;
+
+    vector_type m_twiddles{};
+    // radix-2
+    std::vector<std::pair<usize, usize>> m_swaps{};
+    // mixed radix
+    std::vector<stage> m_stages{};
+    std::vector<usize> m_permutation{};
+    // Bluestein
+    vector_type m_chirp{};
+    vector_type m_kernel{};
+    std::unique_ptr<fft_plan const> m_inner{};
+};
+}  // namespace nrv
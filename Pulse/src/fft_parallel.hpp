@@ -0,0 +1,369 @@
+/**
+ * @file   fft_parallel.hpp
+ * @author Pratchaya Khansomboon (pratchaya.k.git@gmail.com)
+ * @brief  Transforms of an fft_plan on the threads of a thread_pool and
+ *         batches of signals of the same size. Kept out of fft.hpp so the
+ *         firmware's FFT doesn't depend on threads.
+ * @date   2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <complex>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "types.hpp"
+#include "bit_reverse.hpp"
+#include "fft.hpp"
+#include "fft_simd.hpp"
+#include "thread_pool.hpp"
+
+namespace nrv {
+// Smallest transform executed in parallel
+inline constexpr usize fft_parallel_cutoff = usize{1} << 15;
+// Values per block and per task of the parallel transform
+inline constexpr usize fft_parallel_block = usize{1} << 12;
+
+namespace detail {
+// Scratch of the transforms the plan runs on its own behalf, the Bluestein
+// convolution on a pool and the tiles of a batch, where the caller has no
+// buffer to pass. It's grown on the first use in every thread and then reused.
+template <typename T>
+auto thread_scratch(usize const& size) -> std::span<std::complex<T>> {
+    thread_local std::vector<std::complex<T>> buffer{};
+    if (buffer.size() < size) buffer.resize(size);
+    return {buffer.data(), size};
+}
+
+/**
+ * Large radix-2 transforms are spread over the threads of a thread_pool. The
+ * tiles of the bit reversal are split between the threads. Then every block of
+ * fft_parallel_block values is an independent transform for the first stages,
+ * the twiddle table of a stage doesn't depend on N, and the threads take
+ * blocks. The remaining stages are wider than a block, their butterflies are
+ * split into rows of a block and run in fused pairs, one parallel pass per two
+ * stages. Transforms below fft_parallel_cutoff run on the calling thread,
+ * waking the pool costs more than it saves. Bluestein runs its inner
+ * transforms in parallel, mixed radix transforms run serially.
+ *
+ * Batches of signals of the same size use FFTW's advanced layout: value i of
+ * signal b is data[b * dist + i * stride]. Contiguous signals (stride 1) are
+ * transformed where they are. Strided signals, e.g. interleaved with dist 1,
+ * are copied a tile of signals at a time into contiguous scratch, transformed
+ * and copied back. Reading a tile row by row uses every value of a cache line,
+ * running the butterflies directly on the strided rows doesn't and is slower
+ * for the power of 2 strides of an interleaved batch.
+ */
+template <typename T>
+struct fft_parallel {
+    using plan_type    = fft_plan<T>;
+    using complex_type = std::complex<T>;
+
+    static auto execute(plan_type const& plan, std::span<complex_type> data, thread_pool& pool) -> void {
+        plan.check_size(data.size());
+        if (plan.m_size < fft_parallel_cutoff || pool.size() == 1) return plan.execute(data);
+
+        switch (plan.m_algorithm) {
+            case fft_algorithm::radix2:
+                radix2_permute(data, pool);
+                radix2_butterflies(plan, data.data(), pool);
+                break;
+            case fft_algorithm::mixed_radix:
+                plan.execute(data);
+                break;
+            case fft_algorithm::bluestein:
+                // The caller can't pass scratch here, the inner transforms
+                // run on the pool while this thread waits
+                plan.bluestein(data, data, thread_scratch<T>(plan.scratch_size()),
+                               [&](auto const& a, bool const& backward) {
+                                   if (backward) inverse(*plan.m_inner, a, pool);
+                                   else          execute(*plan.m_inner, a, pool);
+                               });
+                break;
+        }
+    }
+
+    static auto inverse(plan_type const& plan, std::span<complex_type> data, thread_pool& pool) -> void {
+        plan.check_size(data.size());
+        if (plan.m_size < fft_parallel_cutoff || pool.size() == 1) return plan.inverse(data);
+        conjugate(data, pool);
+        execute(plan, data, pool);
+        conjugate(data, pool);
+    }
+
+    static auto batch_count(plan_type const& plan, usize const& size) -> usize {
+        if (size % plan.m_size != 0)
+            throw std::invalid_argument("fft_plan: batch size isn't a multiple of the plan size");
+        return size / plan.m_size;
+    }
+
+    // Signals per tile of a strided batch, about 16k values
+    static auto batch_tile(plan_type const& plan) -> usize {
+        return std::clamp<usize>((usize{1} << 14) / plan.m_size, 1, 32);
+    }
+
+    // Largest radix-2 signal transformed in lanes, the structure of arrays
+    // of a tile stays within 512 kB and in L2 for every instruction set
+    static constexpr usize lanes_limit = usize{1} << 12;
+
+    static auto use_lanes(plan_type const& plan) -> bool {
+        return plan.m_algorithm == fft_algorithm::radix2 && plan.m_size <= lanes_limit;
+    }
+
+    /**
+     * Transforms K::lanes signals starting at base in lanes: gathered into
+     * a structure of arrays in bit reversed order, conjugated for the
+     * backward transform, then the stages and the scatter back.
+     */
+    template <typename K>
+    static auto lanes_tile(plan_type const& plan, complex_type* base, usize const& stride, usize const& dist,
+                           bool const& backward) -> void {
+        constexpr auto L = K::lanes;
+        auto const N = plan.m_size;
+        auto const buffer = thread_scratch<T>(N * L + K::align / sizeof(complex_type));
+        auto* rows = reinterpret_cast<T*>(buffer.data());
+        rows += (K::align - reinterpret_cast<std::uintptr_t>(rows) % K::align) % K::align / sizeof(T);
+        auto const sign = backward ? T(-1) : T(1);
+
+        // Value i of every signal goes to row rev(i). Interleaved signals are
+        // read a row at a time, the others a cache line of a signal at a time
+        // since the signals of a contiguous batch are a power of 2 apart and
+        // would evict each other value by value.
+        constexpr auto C = std::max<usize>(64 / sizeof(complex_type), 1);
+        auto const bits  = usize(std::countr_zero(N));
+        auto const block = std::min(C, N);
+        std::array<T*, C> row{};
+        for (usize i = 0; i < N; i += block) {
+            for (usize j = 0; j < block; j++)
+                row[j] = rows + reverse_bits(i + j, bits) * 2 * L;
+            if (dist < stride) {
+                for (usize j = 0; j < block; j++) {
+                    auto const* x = base + (i + j) * stride;
+                    for (usize l = 0; l < L; l++) {
+                        row[j][l]     = x[l * dist].real();
+                        row[j][L + l] = x[l * dist].imag() * sign;
+                    }
+                }
+                continue;
+            }
+            for (usize l = 0; l < L; l++) {
+                auto const* x = base + l * dist + i * stride;
+                for (usize j = 0; j < block; j++) {
+                    row[j][l]     = x[j * stride].real();
+                    row[j][L + l] = x[j * stride].imag() * sign;
+                }
+            }
+        }
+        K::stages(rows, plan.m_twiddles.data(), N);
+        if (dist < stride) {
+            for (usize i = 0; i < N; i++) {
+                auto const* r = rows + i * 2 * L;
+                auto* x       = base + i * stride;
+                for (usize l = 0; l < L; l++)
+                    x[l * dist] = {r[l], r[L + l] * sign};
+            }
+            return;
+        }
+        for (usize i = 0; i < N; i += block) {
+            for (usize l = 0; l < L; l++) {
+                auto* x = base + l * dist + i * stride;
+                for (usize j = 0; j < block; j++) {
+                    auto const* r = rows + (i + j) * 2 * L;
+                    x[j * stride] = {r[l], r[L + l] * sign};
+                }
+            }
+        }
+    }
+
+    /**
+     * Transforms every signal of the batch, forward or backward. Radix-2
+     * signals up to lanes_limit go through the lane kernel a register of
+     * signals at a time, the rest of the batch one signal at a time, copied
+     * a tile at a time into contiguous scratch when strided. With a pool the
+     * tiles are split between its threads, each thread has its own scratch.
+     */
+    static auto batch(plan_type const& plan, std::span<complex_type> data, usize const& count,
+                      usize const& stride, usize const& dist, thread_pool* pool, bool const& backward) -> void {
+        if (count == 0) return;
+        if (stride == 0)
+            throw std::invalid_argument("fft_plan: batch stride needs to be at least 1");
+        if ((count - 1) * dist + (plan.m_size - 1) * stride >= data.size())
+            throw std::invalid_argument("fft_plan: batch layout doesn't fit in the data");
+
+        radix2_lanes_dispatch<T>([&](auto kernel) {
+            using kernel_type = decltype(kernel);
+            auto const N     = plan.m_size;
+            auto const S     = plan.scratch_size();
+            auto const lanes = use_lanes(plan) ? kernel_type::lanes : 0;
+            auto const tile  = lanes != 0 ? lanes : stride == 1 ? usize{1} : batch_tile(plan);
+            auto const transform = [&](std::span<complex_type> x, std::span<complex_type> scratch) {
+                if (backward) plan.inverse(x, x, scratch);
+                else          plan.execute(x, x, scratch);
+            };
+            auto const run = [&](usize first, usize last) {
+                if (last - first == lanes)
+                    return lanes_tile<kernel_type>(plan, data.data() + first * dist, stride, dist, backward);
+
+                // The tile and the scratch of a thread, the batch calls have
+                // no caller buffers and every thread of a pool needs its own
+                auto const buffer  = thread_scratch<T>((stride == 1 ? 0 : tile * N) + S);
+                auto const scratch = buffer.last(S);
+                if (stride == 1) {
+                    for (usize b = first; b < last; b++)
+                        transform(data.subspan(b * dist, N), scratch);
+                    return;
+                }
+
+                auto const rows = last - first;
+                auto* base = data.data() + first * dist;
+                for (usize i = 0; i < N; i++) {
+                    for (usize c = 0; c < rows; c++)
+                        buffer[c * N + i] = base[c * dist + i * stride];
+                }
+                for (usize c = 0; c < rows; c++)
+                    transform(buffer.subspan(c * N, N), scratch);
+                for (usize i = 0; i < N; i++) {
+                    for (usize c = 0; c < rows; c++)
+                        base[c * dist + i * stride] = buffer[c * N + i];
+                }
+            };
+
+            if (pool && count * N >= fft_parallel_cutoff) {
+                // Whole tiles per task, so only the last one is partial
+                auto const grain = (std::max(tile, fft_parallel_block / N) + tile - 1) / tile * tile;
+                pool->parallel_for(0, count, grain, [&](usize first, usize last) {
+                    for (auto b = first; b < last; b += tile)
+                        run(b, std::min(b + tile, last));
+                });
+            } else {
+                for (usize b = 0; b < count; b += tile)
+                    run(b, std::min(b + tile, count));
+            }
+        });
+    }
+
+    static auto conjugate(std::span<complex_type> data, thread_pool& pool) -> void {
+        pool.parallel_for(0, data.size(), fft_parallel_block, [&](usize first, usize last) {
+            plan_type::conjugate(data.subspan(first, last - first));
+        });
+    }
+
+    static auto radix2_permute(std::span<complex_type> data, thread_pool& pool) -> void {
+        auto const blocks = bit_reverse_blocking<complex_type>::blocks(data.size());
+        pool.parallel_for(0, blocks, 1, [&](usize first, usize last) {
+            bit_reverse_permute(data, first, last);
+        });
+    }
+
+    static auto radix2_butterflies(plan_type const& plan, complex_type* data, thread_pool& pool) -> void {
+        constexpr auto B = fft_parallel_block;
+        auto const N   = plan.m_size;
+        auto const* tw = plan.m_twiddles.data();
+
+        // Stages up to B / 2, every block is a transform of its own
+        pool.parallel_for(0, N / B, 1, [&](usize first, usize last) {
+            for (usize b = first; b < last; b++)
+                detail::radix2_butterflies(data + b * B, tw, B);
+        });
+
+        // Wider stages, a task is a row of B / 4 radix-4 or B / 2 radix-2
+        // butterflies. Butterfly j of stage m is column j % m of block j / m.
+        // A range only spans several blocks when the pool runs it serially.
+        detail::radix2_dispatch<T>([&](auto kernel) {
+            using kernel_type = decltype(kernel);
+            usize m = B;
+            for (; 4 * m <= N; m <<= 2) {
+                auto const* w1 = tw + (m - 1);
+                auto const* w2 = tw + (2 * m - 1);
+                pool.parallel_for(0, N / 4, B / 4, [&](usize first, usize last) {
+                    for (auto j = first; j < last;) {
+                        auto const n = j % m;
+                        auto const count = std::min(last - j, m - n);
+                        auto* x = data + 4 * m * (j / m) + n;
+                        kernel_type::rows4(x, m, w1 + n, w2 + n, w2 + m + n, count);
+                        j += count;
+                    }
+                });
+            }
+            if (2 * m <= N) {
+                auto const* w = tw + (m - 1);
+                pool.parallel_for(0, N / 2, B / 2, [&](usize first, usize last) {
+                    for (auto j = first; j < last;) {
+                        auto const n = j % m;
+                        auto const count = std::min(last - j, m - n);
+                        auto* lo = data + 2 * m * (j / m) + n;
+                        kernel_type::rows2(lo, lo + m, w + n, count);
+                        j += count;
+                    }
+                });
+            }
+        });
+    }
+};
+
+// The plan's T only, so a vector converts to the span
+template <typename T>
+using fft_span = std::span<std::complex<std::type_identity_t<T>>>;
+}  // namespace detail
+
+// In-place forward transform on the threads of the pool
+template <typename T>
+auto execute(fft_plan<T> const& plan, detail::fft_span<T> data, thread_pool& pool) -> void {
+    detail::fft_parallel<T>::execute(plan, data, pool);
+}
+
+// In-place backward transform on the threads of the pool, unnormalised
+template <typename T>
+auto inverse(fft_plan<T> const& plan, detail::fft_span<T> data, thread_pool& pool) -> void {
+    detail::fft_parallel<T>::inverse(plan, data, pool);
+}
+
+// In-place forward transforms of count signals, see the batch layout of
+// detail::fft_parallel
+template <typename T>
+auto execute_batch(fft_plan<T> const& plan, detail::fft_span<T> data, usize const& count,
+                   usize const& stride, usize const& dist) -> void {
+    detail::fft_parallel<T>::batch(plan, data, count, stride, dist, nullptr, false);
+}
+
+// Same on the threads of the pool, the signals are split between them
+template <typename T>
+auto execute_batch(fft_plan<T> const& plan, detail::fft_span<T> data, usize const& count,
+                   usize const& stride, usize const& dist, thread_pool& pool) -> void {
+    detail::fft_parallel<T>::batch(plan, data, count, stride, dist, &pool, false);
+}
+
+// In-place forward transforms of data.size() / size() contiguous signals
+template <typename T>
+auto execute_batch(fft_plan<T> const& plan, detail::fft_span<T> data) -> void {
+    execute_batch(plan, data, detail::fft_parallel<T>::batch_count(plan, data.size()), 1, plan.size());
+}
+
+// In-place backward transforms of count signals, see the batch layout of
+// detail::fft_parallel
+template <typename T>
+auto inverse_batch(fft_plan<T> const& plan, detail::fft_span<T> data, usize const& count,
+                   usize const& stride, usize const& dist) -> void {
+    detail::fft_parallel<T>::batch(plan, data, count, stride, dist, nullptr, true);
+}
+
+template <typename T>
+auto inverse_batch(fft_plan<T> const& plan, detail::fft_span<T> data, usize const& count,
+                   usize const& stride, usize const& dist, thread_pool& pool) -> void {
+    detail::fft_parallel<T>::batch(plan, data, count, stride, dist, &pool, true);
+}
+
+template <typename T>
+auto inverse_batch(fft_plan<T> const& plan, detail::fft_span<T> data) -> void {
+    inverse_batch(plan, data, detail::fft_parallel<T>::batch_count(plan, data.size()), 1, plan.size());
+}
+}  // namespace nrv
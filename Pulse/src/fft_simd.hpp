@@ -0,0 +1,560 @@
+/**
+ * @file   fft_simd.hpp
+ * @author Pratchaya Khansomboon (pratchaya.k.git@gmail.com)
+ * @brief  Vectorised radix-2 butterflies for the FFT plan with runtime
+ *         dispatch on the instruction set of the CPU. x86 gets SSE2, AVX2 and
+ *         AVX-512 kernels, every other target uses the scalar kernel.
+ * @date   2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+#include <atomic>
+#include <complex>
+#include <type_traits>
+
+#include "types.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define NRV_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+namespace nrv {
+enum class simd_isa : u8 {
+    scalar,
+    sse2,
+    avx2,    // AVX2 + FMA
+    avx512,  // AVX-512F
+};
+
+constexpr auto to_string(simd_isa const& isa) -> char const* {
+    switch (isa) {
+        case simd_isa::scalar: return "scalar";
+        case simd_isa::sse2:   return "sse2";
+        case simd_isa::avx2:   return "avx2";
+        case simd_isa::avx512: return "avx512";
+    }
+    return "unknown";
+}
+
+// Is the instruction set available on this CPU
+inline auto simd_supported(simd_isa const& isa) -> bool {
+    switch (isa) {
+        case simd_isa::scalar: return true;
+#ifdef NRV_SIMD_X86
+        case simd_isa::sse2:   return __builtin_cpu_supports("sse2");
+        case simd_isa::avx2:   return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+        case simd_isa::avx512: return __builtin_cpu_supports("avx512f");
+#endif
+        default: return false;
+    }
+}
+
+// Widest instruction set available on this CPU, detected once
+inline auto simd_detect() -> simd_isa {
+    static auto const isa = [] {
+        for (auto const isa : {simd_isa::avx512, simd_isa::avx2, simd_isa::sse2}) {
+            if (simd_supported(isa)) return isa;
+        }
+        return simd_isa::scalar;
+    }();
+    return isa;
+}
+
+namespace detail {
+inline auto simd_selected() -> std::atomic<simd_isa>& {
+    static std::atomic<simd_isa> isa{simd_detect()};
+    return isa;
+}
+}  // namespace detail
+
+// Instruction set used by the FFT kernels, the widest available by default
+inline auto simd_active() -> simd_isa {
+    return detail::simd_selected().load(std::memory_order_relaxed);
+}
+
+// Force the kernels to an instruction set, returns false if the CPU lacks it
+inline auto simd_select(simd_isa const& isa) -> bool {
+    if (!simd_supported(isa)) return false;
+    detail::simd_selected().store(isa, std::memory_order_relaxed);
+    return true;
+}
+
+namespace detail {
+/**
+ * count radix-2 butterflies between the rows lo and hi with the twiddles w.
+ * This is the reference for the vector kernels and handles the stages
+ * narrower than a vector register.
+ */
+template <typename T>
+inline auto radix2_row(std::complex<T>* lo, std::complex<T>* hi, std::complex<T> const* w,
+                       usize const& count) -> void {
+    for (usize n = 0; n < count; n++) {
+        auto const& a = hi[n];
+        auto const& b = w[n];
+        auto const z = std::complex<T>{a.real() * b.real() - a.imag() * b.imag(),
+                                       a.real() * b.imag() + a.imag() * b.real()};
+        auto const f = lo[n];
+        lo[n] = f + z;
+        hi[n] = f - z;
+    }
+}
+
+// One radix-2 stage over the whole buffer, stage m combines transforms of
+// length m with the twiddles w[0..m)
+template <typename T>
+inline auto radix2_stage(std::complex<T>* data, std::complex<T> const* w,
+                         usize const& size, usize const& m) -> void {
+    for (usize k = 0; k < size; k += 2 * m)
+        radix2_row(data + k, data + k + m, w, m);
+}
+
+template <typename T>
+inline auto radix2_scalar(std::complex<T>* data, std::complex<T> const* twiddles, usize const& size) -> void {
+    for (usize m = 1; m < size; m <<= 1)
+        radix2_stage(data, twiddles + (m - 1), size, m);
+}
+
+/**
+ * Two radix-2 stages m and 2m fused into one radix-4 pass over the rows
+ * x, x + m, x + 2m and x + 3m:
+ *
+ *   stage m:  (x0, x1) and (x2, x3) with w1 = w_m[n]
+ *   stage 2m: (x0, x2) with w2 = w_2m[n] and (x1, x3) with w3 = w_2m[n + m]
+ *
+ * Without fused multiply-add this is the same sequence of operations as the
+ * two radix-2 stages.
+ */
+template <typename T>
+inline auto radix4_row(std::complex<T>* x, usize const& m, std::complex<T> const* w1,
+                       std::complex<T> const* w2, std::complex<T> const* w3, usize const& count) -> void {
+    auto const mul = [](std::complex<T> const& a, std::complex<T> const& b) {
+        return std::complex<T>{a.real() * b.real() - a.imag() * b.imag(),
+                               a.real() * b.imag() + a.imag() * b.real()};
+    };
+    for (usize n = 0; n < count; n++) {
+        auto const a  = x[n];
+        auto const b  = mul(x[n + m], w1[n]);
+        auto const c  = x[n + 2 * m];
+        auto const d  = mul(x[n + 3 * m], w1[n]);
+        auto const s0 = a + b;
+        auto const s1 = a - b;
+        auto const t2 = mul(c + d, w2[n]);
+        auto const t3 = mul(c - d, w3[n]);
+        x[n]         = s0 + t2;
+        x[n + m]     = s1 + t3;
+        x[n + 2 * m] = s0 - t2;
+        x[n + 3 * m] = s1 - t3;
+    }
+}
+
+// Rows with a vector type V, V::width complex values at a time. count has to
+// be a multiple of the width.
+template <typename V, typename T>
+inline auto radix2_row_vector(std::complex<T>* lo, std::complex<T>* hi, std::complex<T> const* w,
+                              usize const& count) -> void {
+    for (usize n = 0; n < count; n += V::width)
+        V::butterfly2(lo + n, hi + n, w + n);
+}
+
+template <typename V, typename T>
+inline auto radix4_row_vector(std::complex<T>* x, usize const& m, std::complex<T> const* w1,
+                              std::complex<T> const* w2, std::complex<T> const* w3, usize const& count) -> void {
+    for (usize n = 0; n < count; n += V::width)
+        V::butterfly4(x + n, m, w1 + n, w2 + n, w3 + n);
+}
+
+/**
+ * Butterflies for a vector type V. The twiddle table has the layout of
+ * fft_plan, stage m at offset m - 1. The stages narrower than a register are
+ * done with the scalar code, the rest in fused radix-4 passes, halving the
+ * passes over the data, and a final radix-2 stage when the count is odd. Only
+ * the rounding of the fused multiply-add differs from the scalar kernel.
+ */
+template <typename V, typename T>
+inline auto radix2_vector(std::complex<T>* data, std::complex<T> const* twiddles, usize const& size) -> void {
+    constexpr auto W = V::width;
+    usize m = 1;
+    for (; m < W && m < size; m <<= 1)
+        radix2_stage(data, twiddles + (m - 1), size, m);
+
+    for (; 4 * m <= size; m <<= 2) {
+        auto const* w1 = twiddles + (m - 1);
+        auto const* w2 = twiddles + (2 * m - 1);
+        for (usize k = 0; k < size; k += 4 * m)
+            radix4_row_vector<V>(data + k, m, w1, w2, w2 + m, m);
+    }
+
+    if (2 * m <= size) {
+        auto const* w = twiddles + (m - 1);
+        for (usize k = 0; k < size; k += 2 * m)
+            radix2_row_vector<V>(data + k, data + k + m, w, m);
+    }
+}
+
+// Scalar kernel with the same entry points as the vector kernels below
+template <typename T>
+struct radix2_scalar_kernel {
+    using complex_type = std::complex<T>;
+    static auto stages(complex_type* d, complex_type const* w, usize n) -> void {
+        radix2_scalar(d, w, n);
+    }
+    static auto rows2(complex_type* lo, complex_type* hi, complex_type const* w, usize count) -> void {
+        radix2_row(lo, hi, w, count);
+    }
+    static auto rows4(complex_type* x, usize m, complex_type const* w1, complex_type const* w2,
+                      complex_type const* w3, usize count) -> void {
+        radix4_row(x, m, w1, w2, w3, count);
+    }
+};
+
+#ifdef NRV_SIMD_X86
+#define NRV_TARGET_SSE2   __attribute__((target("sse2")))
+#define NRV_TARGET_AVX2   __attribute__((target("avx2,fma")))
+#define NRV_TARGET_AVX512 __attribute__((target("avx512f")))
+
+// The complex product a*b on interleaved values is
+//   re = a.re * b.re - a.im * b.im
+//   im = a.im * b.re + a.re * b.im
+// which is a * dup(b.re) -/+ swap(a) * dup(b.im), even lanes subtract and odd
+// lanes add. AVX2 and AVX-512 do that in one fmaddsub.
+//
+// The butterflies are the same for every vector type, only the target
+// differs. They're generated into each type so the intrinsics are never
+// called from a function compiled for another target.
+#define NRV_SIMD_BUTTERFLIES(TARGET, T)                                                    \
+    TARGET static auto butterfly2(std::complex<T>* lo, std::complex<T>* hi,                \
+                                  std::complex<T> const* w) -> void {                      \
+        auto const z = cmul(load(hi), load(w));                                            \
+        auto const f = load(lo);                                                           \
+        store(lo, add(f, z));                                                              \
+        store(hi, sub(f, z));                                                              \
+    }                                                                                      \
+    TARGET static auto butterfly4(std::complex<T>* x, usize const& m,                      \
+                                  std::complex<T> const* w1, std::complex<T> const* w2,    \
+                                  std::complex<T> const* w3) -> void {                     \
+        auto const a  = load(x);                                                           \
+        auto const b  = cmul(load(x + m), load(w1));                                       \
+        auto const c  = load(x + 2 * m);                                                   \
+        auto const d  = cmul(load(x + 3 * m), load(w1));                                   \
+        auto const s0 = add(a, b);                                                         \
+        auto const s1 = sub(a, b);                                                         \
+        auto const t2 = cmul(add(c, d), load(w2));                                         \
+        auto const t3 = cmul(sub(c, d), load(w3));                                         \
+        store(x,         add(s0, t2));                                                     \
+        store(x + m,     add(s1, t3));                                                     \
+        store(x + 2 * m, sub(s0, t2));                                                     \
+        store(x + 3 * m, sub(s1, t3));                                                     \
+    }
+
+struct sse2_f64 {
+    static constexpr usize width = 1;
+    using reg = __m128d;
+    NRV_TARGET_SSE2 static auto load(std::complex<f64> const* p) -> reg {
+        return _mm_loadu_pd(reinterpret_cast<f64 const*>(p));
+    }
+    NRV_TARGET_SSE2 static auto store(std::complex<f64>* p, reg const& v) -> void {
+        _mm_storeu_pd(reinterpret_cast<f64*>(p), v);
+    }
+    NRV_TARGET_SSE2 static auto cmul(reg const& a, reg const& b) -> reg {
+        auto const sign = _mm_set_pd(0.0, -0.0);
+        auto const re = _mm_unpacklo_pd(b, b);
+        auto const im = _mm_unpackhi_pd(b, b);
+        auto const sw = _mm_shuffle_pd(a, a, 0x1);
+        return _mm_add_pd(_mm_mul_pd(a, re), _mm_xor_pd(_mm_mul_pd(sw, im), sign));
+    }
+    NRV_TARGET_SSE2 static auto add(reg const& a, reg const& b) -> reg { return _mm_add_pd(a, b); }
+    NRV_TARGET_SSE2 static auto sub(reg const& a, reg const& b) -> reg { return _mm_sub_pd(a, b); }
+    NRV_SIMD_BUTTERFLIES(NRV_TARGET_SSE2, f64)
+};
+
+struct sse2_f32 {
+    static constexpr usize width = 2;
+    using reg = __m128;
+    NRV_TARGET_SSE2 static auto load(std::complex<f32> const* p) -> reg {
+        return _mm_loadu_ps(reinterpret_cast<f32 const*>(p));
+    }
+    NRV_TARGET_SSE2 static auto store(std::complex<f32>* p, reg const& v) -> void {
+        _mm_storeu_ps(reinterpret_cast<f32*>(p), v);
+    }
+    NRV_TARGET_SSE2 static auto cmul(reg const& a, reg const& b) -> reg {
+        auto const sign = _mm_set_ps(0.0f, -0.0f, 0.0f, -0.0f);
+        auto const re = _mm_shuffle_ps(b, b, _MM_SHUFFLE(2, 2, 0, 0));
+        auto const im = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 3, 1, 1));
+        auto const sw = _mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1));
+        return _mm_add_ps(_mm_mul_ps(a, re), _mm_xor_ps(_mm_mul_ps(sw, im), sign));
+    }
+    NRV_TARGET_SSE2 static auto add(reg const& a, reg const& b) -> reg { return _mm_add_ps(a, b); }
+    NRV_TARGET_SSE2 static auto sub(reg const& a, reg const& b) -> reg { return _mm_sub_ps(a, b); }
+    NRV_SIMD_BUTTERFLIES(NRV_TARGET_SSE2, f32)
+};
+
+struct avx2_f64 {
+    static constexpr usize width = 2;
+    using reg = __m256d;
+    NRV_TARGET_AVX2 static auto load(std::complex<f64> const* p) -> reg {
+        return _mm256_loadu_pd(reinterpret_cast<f64 const*>(p));
+    }
+    NRV_TARGET_AVX2 static auto store(std::complex<f64>* p, reg const& v) -> void {
+        _mm256_storeu_pd(reinterpret_cast<f64*>(p), v);
+    }
+    NRV_TARGET_AVX2 static auto cmul(reg const& a, reg const& b) -> reg {
+        auto const re = _mm256_movedup_pd(b);
+        auto const im = _mm256_permute_pd(b, 0xF);
+        auto const sw = _mm256_permute_pd(a, 0x5);
+        return _mm256_fmaddsub_pd(a, re, _mm256_mul_pd(sw, im));
+    }
+    NRV_TARGET_AVX2 static auto add(reg const& a, reg const& b) -> reg { return _mm256_add_pd(a, b); }
+    NRV_TARGET_AVX2 static auto sub(reg const& a, reg const& b) -> reg { return _mm256_sub_pd(a, b); }
+    NRV_SIMD_BUTTERFLIES(NRV_TARGET_AVX2, f64)
+};
+
+struct avx2_f32 {
+    static constexpr usize width = 4;
+    using reg = __m256;
+    NRV_TARGET_AVX2 static auto load(std::complex<f32> const* p) -> reg {
+        return _mm256_loadu_ps(reinterpret_cast<f32 const*>(p));
+    }
+    NRV_TARGET_AVX2 static auto store(std::complex<f32>* p, reg const& v) -> void {
+        _mm256_storeu_ps(reinterpret_cast<f32*>(p), v);
+    }
+    NRV_TARGET_AVX2 static auto cmul(reg const& a, reg const& b) -> reg {
+        auto const re = _mm256_moveldup_ps(b);
+        auto const im = _mm256_movehdup_ps(b);
+        auto const sw = _mm256_permute_ps(a, 0xB1);
+        return _mm256_fmaddsub_ps(a, re, _mm256_mul_ps(sw, im));
+    }
+    NRV_TARGET_AVX2 static auto add(reg const& a, reg const& b) -> reg { return _mm256_add_ps(a, b); }
+    NRV_TARGET_AVX2 static auto sub(reg const& a, reg const& b) -> reg { return _mm256_sub_ps(a, b); }
+    NRV_SIMD_BUTTERFLIES(NRV_TARGET_AVX2, f32)
+};
+
+struct avx512_f64 {
+    static constexpr usize width = 4;
+    using reg = __m512d;
+    NRV_TARGET_AVX512 static auto load(std::complex<f64> const* p) -> reg {
+        return _mm512_loadu_pd(reinterpret_cast<f64 const*>(p));
+    }
+    NRV_TARGET_AVX512 static auto store(std::complex<f64>* p, reg const& v) -> void {
+        _mm512_storeu_pd(reinterpret_cast<f64*>(p), v);
+    }
+    // The unmasked AVX-512 shuffles start from _mm512_undefined_pd(), which
+    // GCC 12 reports as maybe-uninitialized. With a full mask the masked form
+    // is the same instruction.
+    NRV_TARGET_AVX512 static auto cmul(reg const& a, reg const& b) -> reg {
+        auto const re = _mm512_mask_movedup_pd(b, 0xFF, b);
+        auto const im = _mm512_mask_permute_pd(b, 0xFF, b, 0xFF);
+        auto const sw = _mm512_mask_permute_pd(a, 0xFF, a, 0x55);
+        return _mm512_fmaddsub_pd(a, re, _mm512_mul_pd(sw, im));
+    }
+    NRV_TARGET_AVX512 static auto add(reg const& a, reg const& b) -> reg { return _mm512_add_pd(a, b); }
+    NRV_TARGET_AVX512 static auto sub(reg const& a, reg const& b) -> reg { return _mm512_sub_pd(a, b); }
+    NRV_SIMD_BUTTERFLIES(NRV_TARGET_AVX512, f64)
+};
+
+struct avx512_f32 {
+    static constexpr usize width = 8;
+    using reg = __m512;
+    NRV_TARGET_AVX512 static auto load(std::complex<f32> const* p) -> reg {
+        return _mm512_loadu_ps(reinterpret_cast<f32 const*>(p));
+    }
+    NRV_TARGET_AVX512 static auto store(std::complex<f32>* p, reg const& v) -> void {
+        _mm512_storeu_ps(reinterpret_cast<f32*>(p), v);
+    }
+    NRV_TARGET_AVX512 static auto cmul(reg const& a, reg const& b) -> reg {
+        auto const re = _mm512_mask_moveldup_ps(b, 0xFFFF, b);
+        auto const im = _mm512_mask_movehdup_ps(b, 0xFFFF, b);
+        auto const sw = _mm512_mask_permute_ps(a, 0xFFFF, a, 0xB1);
+        return _mm512_fmaddsub_ps(a, re, _mm512_mul_ps(sw, im));
+    }
+    NRV_TARGET_AVX512 static auto add(reg const& a, reg const& b) -> reg { return _mm512_add_ps(a, b); }
+    NRV_TARGET_AVX512 static auto sub(reg const& a, reg const& b) -> reg { return _mm512_sub_ps(a, b); }
+    NRV_SIMD_BUTTERFLIES(NRV_TARGET_AVX512, f32)
+};
+
+// Entry points compiled for each instruction set. flatten inlines the whole
+// kernel, so the loops and the intrinsics are compiled for the same target.
+//   stages: every stage of a transform of n values
+//   rows2:  count radix-2 butterflies of one stage
+//   rows4:  count radix-4 butterflies of two fused stages
+#define NRV_RADIX2_KERNEL(NAME, TARGET, V, T)                                                   \
+    struct NAME {                                                                               \
+        using complex_type = std::complex<T>;                                                   \
+        TARGET __attribute__((flatten))                                                         \
+        static auto stages(complex_type* d, complex_type const* w, usize n) -> void {           \
+            radix2_vector<V>(d, w, n);                                                          \
+        }                                                                                       \
+        TARGET __attribute__((flatten))                                                         \
+        static auto rows2(complex_type* lo, complex_type* hi, complex_type const* w,            \
+                          usize count) -> void {                                                \
+            radix2_row_vector<V>(lo, hi, w, count);                                             \
+        }                                                                                       \
+        TARGET __attribute__((flatten))                                                         \
+        static auto rows4(complex_type* x, usize m, complex_type const* w1,                     \
+                          complex_type const* w2, complex_type const* w3, usize count) -> void { \
+            radix4_row_vector<V>(x, m, w1, w2, w3, count);                                      \
+        }                                                                                       \
+    };
+
+template <typename T>
+struct radix2_kernels;
+
+template <>
+struct radix2_kernels<f64> {
+    NRV_RADIX2_KERNEL(sse2,   NRV_TARGET_SSE2,   sse2_f64,   f64)
+    NRV_RADIX2_KERNEL(avx2,   NRV_TARGET_AVX2,   avx2_f64,   f64)
+    NRV_RADIX2_KERNEL(avx512, NRV_TARGET_AVX512, avx512_f64, f64)
+};
+
+template <>
+struct radix2_kernels<f32> {
+    NRV_RADIX2_KERNEL(sse2,   NRV_TARGET_SSE2,   sse2_f32,   f32)
+    NRV_RADIX2_KERNEL(avx2,   NRV_TARGET_AVX2,   avx2_f32,   f32)
+    NRV_RADIX2_KERNEL(avx512, NRV_TARGET_AVX512, avx512_f32, f32)
+};
+#endif  // NRV_SIMD_X86
+
+/**
+ * Calls f with the kernel for the active instruction set, an empty struct
+ * with the static entry points stages, rows2 and rows4. The row kernels need
+ * count to be a multiple of the widest vector, 8 values.
+ */
+template <typename T, typename F>
+inline auto radix2_dispatch(F&& f) -> void {
+#ifdef NRV_SIMD_X86
+    if constexpr (std::is_same_v<T, f64> || std::is_same_v<T, f32>) {
+        switch (simd_active()) {
+            case simd_isa::sse2:   return f(typename radix2_kernels<T>::sse2{});
+            case simd_isa::avx2:   return f(typename radix2_kernels<T>::avx2{});
+            case simd_isa::avx512: return f(typename radix2_kernels<T>::avx512{});
+            case simd_isa::scalar: break;
+        }
+    }
+#endif
+    f(radix2_scalar_kernel<T>{});
+}
+
+// All radix-2 stages of a power of 2 transform with the active instruction set
+template <typename T>
+inline auto radix2_butterflies(std::complex<T>* data, std::complex<T> const* twiddles, usize const& size) -> void {
+    radix2_dispatch<T>([&](auto kernel) { decltype(kernel)::stages(data, twiddles, size); });
+}
+
+/**
+ * Radix-2 transforms of several signals at once, one signal per lane of a
+ * vector of B bytes. The signals are a structure of arrays with a row per
+ * index: row i holds value i of every signal, the real parts and then the
+ * imaginary parts, so both are a vector. A butterfly is the same for every
+ * signal, its twiddle is broadcast and the complex product needs no
+ * shuffles. The stages are fused into radix-4 passes like radix2_vector.
+ * rows has to be aligned to B.
+ */
+template <typename T, usize B>
+struct radix2_lanes {
+    typedef T vector __attribute__((vector_size(B)));
+    static constexpr usize lanes = B / sizeof(T);
+
+    static auto stages(T* rows, std::complex<T> const* twiddles, usize const& size) -> void {
+        auto* x = reinterpret_cast<vector*>(rows);
+        // Real and imaginary part of row i
+        auto const re = [x](usize const& i) -> vector& { return x[2 * i]; };
+        auto const im = [x](usize const& i) -> vector& { return x[2 * i + 1]; };
+        usize m = 1;
+        for (; 4 * m <= size; m <<= 2) {
+            auto const* w1 = twiddles + (m - 1);
+            auto const* w2 = twiddles + (2 * m - 1);
+            for (usize k = 0; k < size; k += 4 * m) {
+                for (usize n = k; n < k + m; n++) {
+                    auto const& a = w1[n - k];
+                    auto const& b = w2[n - k];
+                    auto const& c = w2[n - k + m];
+                    // (x0, x1) and (x2, x3) with w1, then (x0, x2) with w2
+                    // and (x1, x3) with w3
+                    auto const b_r = re(n + m) * a.real() - im(n + m) * a.imag();
+                    auto const b_i = re(n + m) * a.imag() + im(n + m) * a.real();
+                    auto const d_r = re(n + 3 * m) * a.real() - im(n + 3 * m) * a.imag();
+                    auto const d_i = re(n + 3 * m) * a.imag() + im(n + 3 * m) * a.real();
+                    auto const s0_r = re(n) + b_r, s0_i = im(n) + b_i;
+                    auto const s1_r = re(n) - b_r, s1_i = im(n) - b_i;
+                    auto const u_r = re(n + 2 * m) + d_r, u_i = im(n + 2 * m) + d_i;
+                    auto const v_r = re(n + 2 * m) - d_r, v_i = im(n + 2 * m) - d_i;
+                    auto const t2_r = u_r * b.real() - u_i * b.imag();
+                    auto const t2_i = u_r * b.imag() + u_i * b.real();
+                    auto const t3_r = v_r * c.real() - v_i * c.imag();
+                    auto const t3_i = v_r * c.imag() + v_i * c.real();
+                    re(n)         = s0_r + t2_r;
+                    im(n)         = s0_i + t2_i;
+                    re(n + m)     = s1_r + t3_r;
+                    im(n + m)     = s1_i + t3_i;
+                    re(n + 2 * m) = s0_r - t2_r;
+                    im(n + 2 * m) = s0_i - t2_i;
+                    re(n + 3 * m) = s1_r - t3_r;
+                    im(n + 3 * m) = s1_i - t3_i;
+                }
+            }
+        }
+        if (2 * m <= size) {
+            auto const* w = twiddles + (m - 1);
+            for (usize k = 0; k < size; k += 2 * m) {
+                for (usize n = k; n < k + m; n++) {
+                    auto const& a = w[n - k];
+                    auto const z_r = re(n + m) * a.real() - im(n + m) * a.imag();
+                    auto const z_i = re(n + m) * a.imag() + im(n + m) * a.real();
+                    re(n + m) = re(n) - z_r;
+                    im(n + m) = im(n) - z_i;
+                    re(n) += z_r;
+                    im(n) += z_i;
+                }
+            }
+        }
+    }
+};
+
+// Lane kernels for each instruction set, a vector register of signals.
+// flatten compiles the stages for the target like NRV_RADIX2_KERNEL.
+#define NRV_LANES_KERNEL(NAME, TARGET, T, B)                                                   \
+    struct NAME {                                                                              \
+        static constexpr usize lanes = radix2_lanes<T, B>::lanes;                              \
+        static constexpr usize align = B;                                                      \
+        TARGET __attribute__((flatten))                                                        \
+        static auto stages(T* rows, std::complex<T> const* w, usize n) -> void {               \
+            radix2_lanes<T, B>::stages(rows, w, n);                                            \
+        }                                                                                      \
+    };
+
+// Without a target the 16 byte vectors are whatever the compiler makes of
+// them, SSE2 on x86 and pairs or quads of scalars elsewhere
+template <typename T>
+struct radix2_lanes_kernels {
+    NRV_LANES_KERNEL(scalar, , T, 16)
+#ifdef NRV_SIMD_X86
+    NRV_LANES_KERNEL(sse2,   NRV_TARGET_SSE2,   T, 16)
+    NRV_LANES_KERNEL(avx2,   NRV_TARGET_AVX2,   T, 32)
+    NRV_LANES_KERNEL(avx512, NRV_TARGET_AVX512, T, 64)
+#endif
+};
+
+/**
+ * Calls f with the lane kernel for the active instruction set, an empty
+ * struct with the number of lanes, the alignment of the rows and the static
+ * entry point stages(rows, twiddles, size).
+ */
+template <typename T, typename F>
+inline auto radix2_lanes_dispatch(F&& f) -> void {
+    using kernels = radix2_lanes_kernels<T>;
+#ifdef NRV_SIMD_X86
+    switch (simd_active()) {
+        case simd_isa::sse2:   return f(typename kernels::sse2{});
+        case simd_isa::avx2:   return f(typename kernels::avx2{});
+        case simd_isa::avx512: return f(typename kernels::avx512{});
+        case simd_isa::scalar: break;
+    }
+#endif
+    f(typename kernels::scalar{});
+}
+}  // namespace detail
+}  // namespace nrv
@@ -0,0 +1,270 @@
+/**
+ * @file   fir.hpp
+ * @author Pratchaya Khansomboon (pratchaya.k.git@gmail.com)
+ * @brief  FIR filter engine, direct form for short filters and uniformly
+ *         partitioned overlap-save FFT convolution for long ones, and the
+ *         windowed sinc low-pass design.
+ * @date   2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+
+#include <algorithm>
+#include <bit>
+#include <complex>
+#include <numbers>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include "types.hpp"
+#include "rfft.hpp"
+#include "window.hpp"
+
+namespace nrv {
+namespace detail {
+// Dot product over independent partial sums, the compiler keeps them in
+// vector registers, a single sum would wait on every add
+template <typename T>
+auto dot(T const* b, T const* x, usize const& size) -> T {
+    constexpr usize lanes = 8;
+    T sum[lanes]{};
+    usize k = 0;
+    for (; k + lanes <= size; k += lanes)
+        for (usize i = 0; i < lanes; i++) sum[i] += b[k + i] * x[k + i];
+    T y{0};
+    for (; k < size; k++) y += b[k] * x[k];
+    for (usize i = 0; i < lanes; i++) y += sum[i];
+    return y;
+}
+
+/**
+ * The last `size` samples, newest first. Every sample is written twice, at
+ * position p and p + size of a buffer of 2 * size values, so the history is
+ * always the contiguous values [p, p + size) and a filter is a dot product
+ * with it, without the modulo per tap of a plain ring buffer.
+ */
+template <typename T>
+class delay_line {
+  public:
+    explicit delay_line(usize const& size = 0) : m_size(size), m_data(2 * size, T(0)) {}
+
+    auto size() const -> usize { return m_size; }
+    auto data() const -> T const* { return m_data.data() + m_pos; }
+
+    auto push(T const& x) -> void {
+        m_pos = m_pos == 0 ? m_size - 1 : m_pos - 1;
+        m_data[m_pos] = x;
+        m_data[m_pos + m_size] = x;
+    }
+
+    auto reset() -> void {
+        std::fill(std::begin(m_data), std::end(m_data), T(0));
+        m_pos = 0;
+    }
+
+  private:
+    usize m_size = 0;
+    usize m_pos  = 0;
+    std::vector<T> m_data{};
+};
+}  // namespace detail
+
+/**
+ * Windowed sinc low-pass of `taps` coefficients with the cut-off frequency
+ * relative to the sample rate, 0 < cutoff < 0.5, and the DC gain `gain`. The
+ * window is symmetric, the filter has linear phase with a delay of
+ * (taps - 1) / 2 samples.
+ */
+template <typename T>
+auto make_lowpass(usize const& taps, f64 const& cutoff, f64 const& gain = 1.0,
+                  window_type const& window = window_type::blackman) -> std::vector<T> {
+    if (taps == 0 || cutoff <= 0.0 || cutoff >= 0.5)
+        throw std::invalid_argument("make_lowpass: needs a coefficient and 0 < cutoff < 0.5");
+    auto const w = make_window<f64>(window, taps, false);
+    auto const mid = f64(taps - 1) / 2.0;
+    std::vector<f64> h(taps);
+    for (usize i = 0; i < taps; i++) {
+        auto const t = f64(i) - mid;
+        auto const sinc = t == 0.0 ? 2.0 * cutoff : std::sin(2.0 * std::numbers::pi * cutoff * t) / (std::numbers::pi * t);
+        h[i] = sinc * w[i];
+    }
+    auto const sum = std::accumulate(std::begin(h), std::end(h), 0.0);
+    std::vector<T> b(taps);
+    for (usize i = 0; i < taps; i++) b[i] = T(h[i] * gain / sum);
+    return b;
+}
+
+/**
+ * FIR filter y(n) = sum b[k] * x(n - k) over the M coefficients b, the same
+ * coefficient arrays as the labs, streamed one sample or one block at a time.
+ *
+ * The history is a detail::delay_line, the direct form is a dot product.
+ *
+ * Filters longer than direct_limit are split in partitions of P coefficients
+ * (Gardner's hybrid, the partitions uniform like in Wefers' UPOLS):
+ *
+ *   - the head b[0, P) runs in direct form, so there is no added latency and
+ *     the output is sample for sample the same as the direct form
+ *   - the tail b[P, M) only needs samples that are at least P old. Every time
+ *     a block of P samples is complete, the tail output of the next block is
+ *     computed by overlap-save: the last 2P samples are transformed with a
+ *     real FFT of 2P into a frequency domain delay line, multiplied with the
+ *     spectra of the K tail partitions and summed over the line, one inverse
+ *     FFT gives the P outputs.
+ *
+ * Per sample that is P multiplies plus two FFTs of 2P and K * (P + 1) complex
+ * multiplies per P samples, instead of M multiplies. The partition is the
+ * bound on the work done for a single sample, by default about 2 sqrt(M). All
+ * the buffers are allocated by the constructor, filtering doesn't allocate.
+ */
+template <typename T>
+class fir {
+  public:
+    using value_type   = T;
+    using complex_type = std::complex<T>;
+
+    // Filters up to this many coefficients run in direct form only unless the
+    // constructor is told otherwise. The break even point of Pulse/model/fir.cpp
+    // built with -O2 on x86-64, where a vector holds twice as many floats as
+    // doubles. Targets without a vector unit or a double FPU, like the ESP32,
+    // have theirs elsewhere.
+    static constexpr usize default_direct_limit = sizeof(T) > 4 ? 96 : 256;
+
+    /**
+     * Filter with the coefficients b. partition is the number of coefficients
+     * per FFT partition, a power of 2, 0 picks one from the filter length. It
+     * is ignored for filters of up to direct_limit coefficients, a partition
+     * of at least b.size() is the direct form. A direct_limit of 0 partitions
+     * every filter longer than the partition.
+     */
+    explicit fir(std::span<T const> b, usize const& partition = 0,
+                 usize const& direct_limit = default_direct_limit)
+        : m_taps(b.size()), m_partition(pick_partition(b.size(), partition, direct_limit)),
+          m_direct(std::min(m_taps, m_partition)), m_plan(m_taps > m_direct ? 2 * m_partition : 2) {
+        if (b.empty())
+            throw std::invalid_argument("fir: needs at least one coefficient");
+        if (m_taps > m_direct && !std::has_single_bit(m_partition))
+            throw std::invalid_argument("fir: partition needs to be a power of 2");
+
+        m_head.assign(std::begin(b), std::begin(b) + isize(m_direct));
+        m_history = detail::delay_line<T>(m_direct);
+        if (m_taps > m_direct) init_partitions(b.subspan(m_direct));
+    }
+
+    auto taps() const -> usize { return m_taps; }
+    auto partition() const -> usize { return m_partition; }
+
+    // Number of FFT partitions of the tail, 0 for the direct form
+    auto partitions() const -> usize { return m_spectra.size(); }
+
+    // Start over with an all zero history
+    auto reset() -> void {
+        m_history.reset();
+        std::fill(std::begin(m_frame), std::end(m_frame), T(0));
+        std::fill(std::begin(m_tail), std::end(m_tail), T(0));
+        for (auto& s : m_line) std::fill(std::begin(s), std::end(s), complex_type{});
+        m_fill = 0;
+        m_line_head = 0;
+    }
+
+    // Filter one sample
+    auto operator()(T const& x) -> T {
+        m_history.push(x);
+        auto y = detail::dot(m_head.data(), m_history.data(), m_direct);
+
+        if (m_spectra.empty()) return y;
+        y += m_tail[m_fill];
+        m_frame[m_partition + m_fill] = x;
+        if (++m_fill == m_partition) {
+            run_partitions();
+            m_fill = 0;
+        }
+        return y;
+    }
+
+    // Filter a block, in and out may be the same buffer
+    auto process(std::span<T const> in, std::span<T> out) -> void {
+        if (in.size() != out.size())
+            throw std::invalid_argument("fir: input and output sizes don't match");
+        for (usize i = 0; i < in.size(); i++) out[i] = (*this)(in[i]);
+    }
+
+  private:
+    static auto pick_partition(usize const& taps, usize const& partition, usize const& direct_limit) -> usize {
+        if (taps <= direct_limit) return taps;
+        if (partition != 0) return partition;
+        auto const root = usize(std::sqrt(f64(taps)));
+        return std::clamp<usize>(2 * std::bit_ceil(root), 16, 4096);
+    }
+
+    auto init_partitions(std::span<T const> tail) -> void {
+        auto const P = m_partition;
+        auto const K = (tail.size() + P - 1) / P;
+        m_frame.assign(2 * P, T(0));
+        m_time.assign(2 * P, T(0));
+        m_tail.assign(P, T(0));
+        m_sum.assign(m_plan.bins(), complex_type{});
+        m_scratch.assign(m_plan.scratch_size(), complex_type{});
+        m_line.assign(K, std::vector<complex_type>(m_plan.bins()));
+
+        // Partition k zero padded to 2P, the second half of the frame is the
+        // newest block, so the last P outputs are the linear convolution
+        m_spectra.reserve(K);
+        for (usize k = 0; k < K; k++) {
+            auto const part = tail.subspan(k * P, std::min(P, tail.size() - k * P));
+            std::fill(std::begin(m_time), std::end(m_time), T(0));
+            std::copy(std::begin(part), std::end(part), std::begin(m_time));
+            m_spectra.emplace_back(m_plan.bins());
+            m_plan.execute(m_time, m_spectra.back(), m_scratch);
+        }
+    }
+
+    // A block of P samples is complete, the tail output of the next block
+    auto run_partitions() -> void {
+        auto const P = m_partition;
+        auto const K = m_spectra.size();
+        m_plan.execute(m_frame, m_line[m_line_head], m_scratch);
+
+        // Partition k meets the block k blocks before the newest, the line
+        // is walked backwards from its head
+        std::fill(std::begin(m_sum), std::end(m_sum), complex_type{});
+        auto line = m_line_head;
+        for (usize k = 0; k < K; k++) {
+            auto const& x = m_line[line];
+            auto const& h = m_spectra[k];
+            for (usize i = 0; i < m_sum.size(); i++) m_sum[i] += detail::cmul(x[i], h[i]);
+            line = line == 0 ? K - 1 : line - 1;
+        }
+        m_plan.inverse(m_sum, m_time, m_scratch);
+
+        std::copy_n(m_time.data() + P, P, m_tail.data());
+        std::copy_n(m_frame.data() + P, P, m_frame.data());
+        m_line_head = m_line_head + 1 == K ? 0 : m_line_head + 1;
+    }
+
+  private:
+    usize m_taps      = 0;
+    usize m_partition = 0;
+    usize m_direct    = 0;
+    std::vector<T> m_head{};
+    detail::delay_line<T> m_history{};
+
+    // Partitioned tail
+    rfft_plan<T> m_plan;
+    usize m_fill      = 0;
+    usize m_line_head = 0;
+    std::vector<T> m_frame{};
+    std::vector<T> m_time{};
+    std::vector<T> m_tail{};
+    std::vector<complex_type> m_sum{};
+    std::vector<complex_type> m_scratch{};
+    std::vector<std::vector<complex_type>> m_spectra{};
+    std::vector<std::vector<complex_type>> m_line{};
+};
+}  // namespace nrv
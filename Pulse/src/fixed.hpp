@@ -0,0 +1,364 @@
+/**
+ * @file   fixed.hpp
+ * @author Pratchaya Khansomboon (pratchaya.k.git@gmail.com)
+ * @brief  Fixed point FIR, second order section IIR and block floating point
+ *         FFT kernels on the saturating q15 and q31 types.
+ * @date   2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+
+#include <algorithm>
+#include <array>
+#include <numbers>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include "types.hpp"
+#include "sos.hpp"
+#include "bit_reverse.hpp"
+
+namespace nrv {
+namespace detail {
+/**
+ * Sums of up to 2^guard products of two fixed point Q values in 64 bits. A
+ * q15 product has 30 fraction bits and is summed as it is. A q31 product has
+ * 62, as many as needed for the guard bits are dropped before summing.
+ */
+template <typename Q, int guard>
+struct fixed_accumulator {
+    static constexpr int drop = std::max(0, 2 * Q::fraction_bits + guard - 63);
+    static constexpr int fraction_bits = 2 * Q::fraction_bits - drop;
+
+    using raw_type  = typename Q::raw_type;
+    using wide_type = typename Q::wide_type;
+
+    static constexpr auto product(raw_type const& a, raw_type const& b) -> i64 {
+        return i64((wide_type(a) * wide_type(b)) >> drop);
+    }
+
+    // The sum of fraction_bits - shift fraction bits rounded to nearest into Q
+    static constexpr auto round(i64 const& sum, int const& shift) -> Q {
+        return Q::saturate(typename Q::wide_type((sum + (i64{1} << (shift - 1))) >> shift));
+    }
+};
+}  // namespace detail
+
+// Converts the floating point values to fixed point, rounded and saturated
+template <typename Q, typename Range>
+auto to_fixed(Range const& in) -> std::vector<Q> {
+    std::vector<Q> out{};
+    for (auto const& x : in) out.push_back(Q::from(f64(x)));
+    return out;
+}
+
+/**
+ * FIR filter y(n) = sum b[k] * x(n - k) with Q coefficients and samples, q15
+ * or q31, the coefficients need |b[k]| < 1, e.g. to_fixed<q15>() of
+ * make_lowpass(). Summed in 64 bits, exactly for q15 and with 46 fraction bits
+ * for q31, rounded and saturated once per output, the sum of up to 2^17 taps
+ * can't overflow. The history is stored twice like detail::delay_line, it's
+ * always the contiguous values newest first and the taps are a dot product of
+ * integers.
+ */
+template <typename Q>
+class fixed_fir {
+    using accumulator = detail::fixed_accumulator<Q, 17>;
+
+  public:
+    using value_type = Q;
+
+    explicit fixed_fir(std::span<Q const> b) : m_b(std::begin(b), std::end(b)), m_line(2 * b.size()) {
+        if (b.empty())
+            throw std::invalid_argument("fixed_fir: needs at least one coefficient");
+    }
+
+    auto taps() const -> usize { return m_b.size(); }
+
+    auto reset() -> void {
+        std::fill(std::begin(m_line), std::end(m_line), Q{});
+        m_pos = 0;
+    }
+
+    auto operator()(Q const& x) -> Q {
+        auto const M = m_b.size();
+        m_pos = m_pos == 0 ? M - 1 : m_pos - 1;
+        m_line[m_pos] = x;
+        m_line[m_pos + M] = x;
+
+        constexpr usize lanes = 8;
+        auto const* h = m_line.data() + m_pos;
+        i64 sum[lanes]{};
+        usize k = 0;
+        for (; k + lanes <= M; k += lanes)
+            for (usize i = 0; i < lanes; i++) sum[i] += accumulator::product(m_b[k + i].raw, h[k + i].raw);
+        i64 y = 0;
+        for (; k < M; k++) y += accumulator::product(m_b[k].raw, h[k].raw);
+        for (usize i = 0; i < lanes; i++) y += sum[i];
+        return accumulator::round(y, accumulator::fraction_bits - Q::fraction_bits);
+    }
+
+    // Filter a block, in and out may be the same buffer
+    auto process(std::span<Q const> in, std::span<Q> out) -> void {
+        if (in.size() != out.size())
+            throw std::invalid_argument("fixed_fir: input and output sizes don't match");
+        for (usize i = 0; i < in.size(); i++) out[i] = (*this)(in[i]);
+    }
+
+  private:
+    std::vector<Q> m_b{};
+    std::vector<Q> m_line{};
+    usize m_pos = 0;
+};
+
+/**
+ * Cascade of N second order sections in fixed point, the same coefficients
+ * as sos. Every section runs in direct form I, the four history values are
+ * samples and the only rounding is the output of the section:
+ *
+ *   y(n) = b0 x(n) + b1 x(n - 1) + b2 x(n - 2) - a1 y(n - 1) - a2 y(n - 2)
+ *
+ * The coefficients are stored with one integer bit, |c| < 2, enough for a1
+ * of any stable section. Before quantising, the cascade is scaled so the
+ * peak gain from the input to the output of every section but the last is
+ * 1, a section can't overflow, and the last section restores the gain of
+ * the filter. A filter of poles close to the unit circle loses its response
+ * in q15 coefficients, e.g. the Pulse low-pass at 5 Hz of 1 kHz, use q31.
+ *
+ * With error feedback the bits dropped when rounding the output of a
+ * section are added to its next sum, first order noise shaping, the
+ * rounding noise isn't amplified by the high gain of a narrow low frequency
+ * section at DC.
+ */
+template <typename Q, usize N>
+class fixed_sos {
+    static_assert(N > 0, "fixed_sos needs at least one section");
+    // Five products and the error, exact for q15 and 60 fraction bits for q31
+    using accumulator = detail::fixed_accumulator<Q, 3>;
+
+  public:
+    using value_type = Q;
+
+    // Coefficients of a floating point cascade, scaled as described above
+    template <typename T>
+    explicit fixed_sos(sos<T, N> const& filter, bool const& error_feedback = true)
+        : m_error_feedback(error_feedback) {
+        auto const sections = scale(filter.sections());
+        for (usize i = 0; i < N; i++) {
+            auto const& c = sections[i];
+            for (auto const v : {c.b0, c.b1, c.b2, c.a1, c.a2})
+                if (!(std::abs(v) < 2.0))
+                    throw std::invalid_argument("fixed_sos: a scaled coefficient is outside (-2, 2)");
+            m_sections[i] = {coefficient(c.b0), coefficient(c.b1), coefficient(c.b2),
+                             coefficient(-c.a1), coefficient(-c.a2)};
+        }
+    }
+
+    // From MATLAB's sos matrix and gain, see sos
+    template <typename U, usize G>
+    fixed_sos(U const (&matrix)[N][6], U const (&gain)[G], bool const& error_feedback = true)
+        : fixed_sos(sos<f64, N>{matrix, gain}, error_feedback) {}
+
+    static constexpr auto size() -> usize { return N; }
+
+    // The scaled and quantised coefficients the filter runs with
+    auto sections() const -> std::array<biquad<f64>, N> {
+        std::array<biquad<f64>, N> sections{};
+        auto const value = [](raw_type const& c) { return 2.0 * Q{c}.to(); };
+        for (usize i = 0; i < N; i++) {
+            auto const& c = m_sections[i];
+            sections[i] = {value(c[0]), value(c[1]), value(c[2]), -value(c[3]), -value(c[4])};
+        }
+        return sections;
+    }
+
+    auto reset() -> void { m_state = {}; }
+
+    auto operator()(Q const& x) -> Q {
+        // The coefficients have one fraction bit less than Q
+        constexpr int shift = accumulator::fraction_bits - 1 - Q::fraction_bits;
+        constexpr i64 dropped = (i64{1} << shift) - 1;
+        auto y = x;
+        for (usize i = 0; i < N; i++) {
+            auto const& c = m_sections[i];
+            auto& s = m_state[i];
+            auto const in = y.raw;
+            auto const sum = s.error + accumulator::product(c[0], in) + accumulator::product(c[1], s.x1)
+                           + accumulator::product(c[2], s.x2) + accumulator::product(c[3], s.y1)
+                           + accumulator::product(c[4], s.y2);
+            if (m_error_feedback) {
+                y = Q::saturate(typename Q::wide_type(sum >> shift));
+                s.error = sum & dropped;
+            } else {
+                y = accumulator::round(sum, shift);
+            }
+            s.x2 = s.x1;
+            s.x1 = in;
+            s.y2 = s.y1;
+            s.y1 = y.raw;
+        }
+        return y;
+    }
+
+    // Filter a block, in and out may be the same buffer
+    auto process(std::span<Q const> in, std::span<Q> out) -> void {
+        if (in.size() != out.size())
+            throw std::invalid_argument("fixed_sos: input and output sizes don't match");
+        for (usize i = 0; i < in.size(); i++) out[i] = (*this)(in[i]);
+    }
+
+  private:
+    using raw_type = typename Q::raw_type;
+
+    struct state {
+        raw_type x1 = 0, x2 = 0;
+        raw_type y1 = 0, y2 = 0;
+        i64 error = 0;
+    };
+
+    // One integer bit, the value c / 2 in Q
+    static auto coefficient(f64 const& c) -> raw_type { return Q::from(c / 2.0).raw; }
+
+    // The peak gain over frequency of the sections [0, count)
+    static auto peak_gain(std::array<biquad<f64>, N> const& sections, usize const& count) -> f64 {
+        constexpr usize points = 1024;
+        f64 peak = 0.0;
+        for (usize k = 0; k <= points; k++) {
+            auto const w = std::numbers::pi * f64(k) / f64(points);
+            auto const c1 = std::cos(w), s1 = -std::sin(w);
+            auto const c2 = std::cos(2.0 * w), s2 = -std::sin(2.0 * w);
+            f64 gain = 1.0;
+            for (usize i = 0; i < count; i++) {
+                auto const& c = sections[i];
+                auto const nr = c.b0 + c.b1 * c1 + c.b2 * c2, ni = c.b1 * s1 + c.b2 * s2;
+                auto const dr = 1.0 + c.a1 * c1 + c.a2 * c2, di = c.a1 * s1 + c.a2 * s2;
+                gain *= std::sqrt((nr * nr + ni * ni) / (dr * dr + di * di));
+            }
+            peak = std::max(peak, gain);
+        }
+        return peak;
+    }
+
+    // Every section but the last scaled to a peak gain of 1 up to its output
+    template <typename T>
+    static auto scale(std::array<biquad<T>, N> const& sections) -> std::array<biquad<f64>, N> {
+        std::array<biquad<f64>, N> scaled{};
+        for (usize i = 0; i < N; i++)
+            scaled[i] = {f64(sections[i].b0), f64(sections[i].b1), f64(sections[i].b2),
+                         f64(sections[i].a1), f64(sections[i].a2)};
+        f64 moved = 1.0;  // Gain taken out of the sections before
+        for (usize i = 0; i < N; i++) {
+            auto& c = scaled[i];
+            auto const g = i + 1 < N ? 1.0 / peak_gain(scaled, i + 1) : moved;
+            c.b0 *= g;
+            c.b1 *= g;
+            c.b2 *= g;
+            moved /= g;
+        }
+        return scaled;
+    }
+
+  private:
+    bool m_error_feedback = true;
+    std::array<std::array<raw_type, 5>, N> m_sections{};  // b0, b1, b2, -a1, -a2
+    std::array<state, N> m_state{};
+};
+
+template <typename Q>
+struct fixed_complex {
+    Q re{};
+    Q im{};
+};
+
+/**
+ * Radix-2 FFT of fixed point values in block floating point. A butterfly
+ * a +- w * b can grow a real or imaginary part by up to 1 + sqrt(2). Before
+ * every stage the largest part of the block is checked and the whole block
+ * is shifted right until it's below sqrt(2) - 1, so the stage can't
+ * overflow, and every shift is counted in the common exponent of the block.
+ * A fixed scale by 1/2 every stage would lose log2(size) bits on any input,
+ * block floating point only shifts when the values grow.
+ *
+ * The twiddle factors are Q, w^0 = 1 isn't and is a plain add. The butterfly
+ * products are rounded to nearest. No allocation after construction.
+ */
+template <typename Q>
+class fixed_fft {
+  public:
+    using value_type   = Q;
+    using complex_type = fixed_complex<Q>;
+
+    explicit fixed_fft(usize const& size) : m_size(size), m_swaps(bit_reverse_pairs(size)) {
+        m_twiddles.resize(size / 2);
+        for (usize k = 0; k < size / 2; k++) {
+            auto const phase = -2.0 * std::numbers::pi * f64(k) / f64(size);
+            m_twiddles[k] = {Q::from(std::cos(phase)), Q::from(std::sin(phase))};
+        }
+    }
+
+    auto size() const -> usize { return m_size; }
+
+    /**
+     * In-place forward transform, data.size() must equal size(). Returns the
+     * block exponent e, the transform is data * 2^e.
+     */
+    auto execute(std::span<complex_type> data) const -> i32 {
+        using wide = typename Q::wide_type;
+        constexpr int F = Q::fraction_bits;
+        constexpr wide limit = wide((std::numbers::sqrt2 - 1.0) * f64(wide{1} << F));
+        constexpr wide half = wide{1} << (F - 1);
+
+        if (data.size() != m_size)
+            throw std::invalid_argument("fixed_fft: data size doesn't match the plan");
+        bit_reverse_permute(data, std::span(m_swaps));
+
+        i32 exponent = 0;
+        for (usize len = 2; len <= m_size; len *= 2) {
+            wide peak = 0;
+            for (auto const& v : data)
+                peak = std::max({peak, v.re.raw < 0 ? -wide(v.re.raw) : wide(v.re.raw),
+                                 v.im.raw < 0 ? -wide(v.im.raw) : wide(v.im.raw)});
+            int shift = 0;
+            for (; (peak >> shift) >= limit; shift++) {}
+            if (shift > 0) {
+                auto const round = wide{1} << (shift - 1);
+                for (auto& v : data) {
+                    v.re.raw = typename Q::raw_type((wide(v.re.raw) + round) >> shift);
+                    v.im.raw = typename Q::raw_type((wide(v.im.raw) + round) >> shift);
+                }
+                exponent += shift;
+            }
+
+            auto const m = len / 2;
+            auto const step = m_size / len;
+            for (usize start = 0; start < m_size; start += len) {
+                for (usize k = 0; k < m; k++) {
+                    auto& a = data[start + k];
+                    auto& b = data[start + k + m];
+                    auto t = b;
+                    if (k != 0) {
+                        auto const& w = m_twiddles[k * step];
+                        auto const br = wide(b.re.raw), bi = wide(b.im.raw);
+                        auto const wr = wide(w.re.raw), wi = wide(w.im.raw);
+                        t.re = Q::saturate((br * wr - bi * wi + half) >> F);
+                        t.im = Q::saturate((br * wi + bi * wr + half) >> F);
+                    }
+                    b = {a.re - t.re, a.im - t.im};
+                    a = {a.re + t.re, a.im + t.im};
+                }
+            }
+        }
+        return exponent;
+    }
+
+  private:
+    usize m_size = 0;
+    std::vector<std::pair<usize, usize>> m_swaps{};
+    std::vector<complex_type> m_twiddles{};
+};
+}  // namespace nrv
@@ -0,0 +1,149 @@
+/**
+ * @file   heart_rate.hpp
+ * @author Pratchaya Khansomboon (pratchaya.k.git@gmail.com)
+ * @brief  Heart rate from the autocorrelation of the last seconds of the
+ *         pulse signal, computed with a real FFT.
+ * @date   2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+
+#include <algorithm>
+#include <bit>
+#include <complex>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include "types.hpp"
+#include "rfft.hpp"
+
+namespace nrv {
+// Result of heart_rate::estimate(), all 0 when no period was found
+template <typename T>
+struct heart_rate_estimate {
+    T bpm        = T(0);  // beats per minute
+    T period     = T(0);  // autocorrelation peak lag in samples, interpolated
+    T confidence = T(0);  // normalised autocorrelation at the peak, 0 to 1
+};
+
+/**
+ * Heart rate estimator for a window of the pulse signal. By Wiener-Khinchin
+ * the autocorrelation r is the inverse transform of the power spectrum. The
+ * window, mean removed, is zero padded to a power of two of at least twice
+ * its length, so the circular correlation of the FFT is the linear one at
+ * every lag. r[k] sums n - k products, divided by that and by r[0] / n
+ * it's the correlation coefficient of the signal with itself k samples
+ * later, 1 for a perfectly periodic signal.
+ *
+ * The peak is the largest local maximum between the lags of max_bpm and
+ * min_bpm. A periodic signal also peaks at multiples of its period, so the
+ * shortest lag local maximum reaching subharmonic_ratio of the peak is
+ * taken instead. A parabola through the peak and its neighbours refines the
+ * lag to a fraction of a sample, its height is the confidence.
+ *
+ * The estimate only needs to run a few times per second, samples cost
+ * nothing until then: keep them in a ring and pass its spans(). The FFT
+ * plan and the buffers are made by the constructor, estimate() doesn't
+ * allocate.
+ */
+template <typename T>
+class heart_rate {
+  public:
+    using value_type   = T;
+    using complex_type = std::complex<T>;
+
+    static constexpr T subharmonic_ratio = T(0.9);
+
+    // Sample rate fs, up to window samples per estimate
+    heart_rate(T const& fs, usize const& window, T const& min_bpm = T(40), T const& max_bpm = T(200))
+        : m_fs(fs), m_window(window), m_min_lag(lag(fs, max_bpm, false)), m_max_lag(lag(fs, min_bpm, true)),
+          m_plan(plan_size(window, m_min_lag, m_max_lag)), m_frame(m_plan.size()), m_bins(m_plan.bins()),
+          m_scratch(m_plan.scratch_size()) {}
+
+    auto window() const -> usize { return m_window; }
+    auto fft_size() const -> usize { return m_plan.size(); }
+    // Lags searched, in samples
+    auto min_lag() const -> usize { return m_min_lag; }
+    auto max_lag() const -> usize { return m_max_lag; }
+
+    /**
+     * Estimate from the samples of first then second, oldest first, at most
+     * window() together. With fewer than max_lag() + 2 samples, or a flat
+     * signal, nothing is found.
+     */
+    auto estimate(std::span<T const> first, std::span<T const> second = {}) -> heart_rate_estimate<T> {
+        auto const n = first.size() + second.size();
+        if (n > m_window)
+            throw std::invalid_argument("heart_rate: more samples than the window");
+        if (n < m_max_lag + 2) return {};
+
+        auto const frame = std::span<T>(m_frame);
+        std::copy(std::begin(first), std::end(first), std::begin(frame));
+        std::copy(std::begin(second), std::end(second), std::begin(frame) + std::ptrdiff_t(first.size()));
+        T mean{0};
+        for (usize i = 0; i < n; i++) mean += frame[i];
+        mean /= T(n);
+        for (usize i = 0; i < n; i++) frame[i] -= mean;
+        std::fill(std::begin(frame) + std::ptrdiff_t(n), std::end(frame), T(0));
+
+        m_plan.execute(m_frame, m_bins, m_scratch);
+        for (auto& bin : m_bins) bin = {std::norm(bin), T(0)};
+        m_plan.inverse(m_bins, m_frame, m_scratch);
+
+        auto const r0 = frame[0] / T(n);
+        if (!(r0 > T(0))) return {};
+        auto const rho = [&](usize const& k) { return frame[k] / (T(n - k) * r0); };
+        auto const is_peak = [&](usize const& k) { return rho(k) > rho(k - 1) && rho(k) >= rho(k + 1); };
+
+        usize best = 0;
+        for (usize k = m_min_lag; k <= m_max_lag; k++)
+            if (is_peak(k) && (best == 0 || rho(k) > rho(best))) best = k;
+        if (best == 0) return {};
+        for (usize k = m_min_lag; k < best; k++) {
+            if (is_peak(k) && rho(k) >= subharmonic_ratio * rho(best)) {
+                best = k;
+                break;
+            }
+        }
+
+        auto const a = rho(best - 1), b = rho(best), c = rho(best + 1);
+        auto const curvature = a - T(2) * b + c;
+        auto const delta = curvature < T(0) ? T(0.5) * (a - c) / curvature : T(0);
+        auto const period = T(best) + delta;
+        auto const height = b - T(0.25) * (a - c) * delta;
+        return {T(60) * m_fs / period, period, std::clamp(height, T(0), T(1))};
+    }
+
+  private:
+    // Lag of bpm at fs in samples, rounded outwards
+    static auto lag(T const& fs, T const& bpm, bool const& up) -> usize {
+        if (!(fs > T(0)) || !(bpm > T(0)))
+            throw std::invalid_argument("heart_rate: the sample rate and the BPM range have to be positive");
+        auto const samples = f64(fs) * 60.0 / f64(bpm);
+        return std::max(usize(up ? std::ceil(samples) : std::floor(samples)), usize{1});
+    }
+
+    static auto plan_size(usize const& window, usize const& min_lag, usize const& max_lag) -> usize {
+        if (min_lag >= max_lag)
+            throw std::invalid_argument("heart_rate: min_bpm has to be below max_bpm");
+        if (window < max_lag + 2)
+            throw std::invalid_argument("heart_rate: the window has to be longer than the period of min_bpm");
+        return std::bit_ceil(2 * window);
+    }
+
+  private:
+    T     m_fs{};
+    usize m_window  = 0;
+    usize m_min_lag = 0;
+    usize m_max_lag = 0;
+    rfft_plan<T> m_plan;
+    std::vector<T> m_frame{};
+    std::vector<complex_type> m_bins{};
+    std::vector<complex_type> m_scratch{};
+};
+}  // namespace nrv
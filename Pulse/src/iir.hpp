@@ -0,0 +1,169 @@
+/**
+ * @file   iir.hpp
+ * @author Pratchaya Khansomboon (pratchaya.k.git@gmail.com)
+ * @brief  Direct form I IIR filter with the tap counts, and optionally the
+ *         coefficients, known at compile time.
+ * @date   2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+#include <array>
+#include <iterator>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "types.hpp"
+
+namespace nrv {
+namespace detail {
+// Runtime coefficients of an iir, empty when they are part of the type
+template <typename T, usize NB, usize NA, bool is_static>
+struct iir_coefficients {
+    std::array<T, NB> m_b{};
+    std::array<T, NA> m_a{};
+};
+
+template <typename T, usize NB, usize NA>
+struct iir_coefficients<T, NB, NA, true> {};
+}  // namespace detail
+
+/**
+ * IIR filter of the polynomials b, NB coefficients, and a, NA coefficients,
+ * in direct form I:
+ *
+ *   y(n) = sum_i b[i] * x(n - i) - sum_i>0 a[i] * y(n - i)
+ *
+ * The tap counts are template parameters, the sums and the shift of the
+ * history are expanded over an index sequence into straight line code, no
+ * loop, no modulo indexing, and every tap a multiply-add the compiler can
+ * fuse. Every instance owns its history, so any number of channels can run
+ * side by side.
+ *
+ * Coefficients is either void, the coefficients are given to the
+ * constructor, or a type with the two arrays as constants:
+ *
+ *   struct high_pass {
+ *       static constexpr f64 b[] = {...};
+ *       static constexpr f64 a[] = {...};
+ *   };
+ *
+ * which puts them into the instructions as immediates, see iir_of. a is
+ * normalised to a[0] = 1. A high order polynomial is sensitive to rounding
+ * of its coefficients, in float prefer sos.hpp.
+ */
+template <typename T, usize NB, usize NA, typename Coefficients = void>
+class iir : private detail::iir_coefficients<T, NB, NA, !std::is_void_v<Coefficients>> {
+    static_assert(NB > 0 && NA > 0, "iir needs at least b[0] and a[0]");
+
+  public:
+    using value_type = T;
+
+    static constexpr bool is_static = !std::is_void_v<Coefficients>;
+
+    constexpr iir() {
+        if constexpr (is_static) {
+            static_assert(std::size(Coefficients::b) == NB && std::size(Coefficients::a) == NA,
+                          "the tap counts differ from the coefficients");
+            static_assert(Coefficients::a[0] != 0, "a[0] can't be 0");
+        } else {
+            this->m_b[0] = T(1);
+            this->m_a[0] = T(1);
+        }
+    }
+
+    template <typename U>
+    iir(U const (&b)[NB], U const (&a)[NA]) {
+        static_assert(!is_static, "the coefficients are already part of the type");
+        if (a[0] == U(0))
+            throw std::invalid_argument("iir: a[0] can't be 0");
+        auto const a0 = f64(a[0]);
+        for (usize i = 0; i < NB; i++) this->m_b[i] = T(f64(b[i]) / a0);
+        for (usize i = 0; i < NA; i++) this->m_a[i] = T(f64(a[i]) / a0);
+    }
+
+    static constexpr auto order() -> usize { return (NB > NA ? NB : NA) - 1; }
+
+    auto reset() -> void {
+        m_x.fill(T(0));
+        m_y.fill(T(0));
+    }
+
+    auto operator()(T const& x) -> T { return step(m_x, m_y, x); }
+
+    /**
+     * Filter a block, in and out may be the same buffer. The history is
+     * copied into locals for the block, so the compiler can keep it in
+     * registers and rename the shift instead of storing it every sample.
+     */
+    auto process(std::span<T const> in, std::span<T> out) -> void {
+        if (in.size() != out.size())
+            throw std::invalid_argument("iir: input and output sizes don't match");
+        auto x = m_x;
+        auto y = m_y;
+        for (usize n = 0; n < in.size(); n++) out[n] = step(x, y, in[n]);
+        m_x = x;
+        m_y = y;
+    }
+
+  private:
+    using x_history = std::array<T, NB>;                   // x(n), x(n - 1), ...
+    using y_history = std::array<T, (NA > 1 ? NA - 1 : 1)>;  // y(n - 1), y(n - 2), ...
+
+    auto step(x_history& x, y_history& y, T const& value) const -> T {
+        shift(x, value, std::make_index_sequence<NB - 1>{});
+        auto const out = feedforward(x, std::make_index_sequence<NB - 1>{})
+                       - feedback(y, std::make_index_sequence<NA - 1>{});
+        if constexpr (NA > 1) shift(y, out, std::make_index_sequence<NA - 2>{});
+        return out;
+    }
+
+    template <usize I>
+    constexpr auto b() const -> T {
+        if constexpr (is_static) return T(f64(Coefficients::b[I]) / f64(Coefficients::a[0]));
+        else return this->m_b[I];
+    }
+
+    template <usize I>
+    constexpr auto a() const -> T {
+        if constexpr (is_static) return T(f64(Coefficients::a[I]) / f64(Coefficients::a[0]));
+        else return this->m_a[I];
+    }
+
+    // b[0] * x(n) + b[1] * x(n - 1) + ...
+    template <usize... I>
+    auto feedforward(x_history const& x, std::index_sequence<I...>) const -> T {
+        auto sum = b<0>() * x[0];
+        ((sum += b<I + 1>() * x[I + 1]), ...);
+        return sum;
+    }
+
+    // a[1] * y(n - 1) + a[2] * y(n - 2) + ...
+    template <usize... I>
+    auto feedback(y_history const& y, std::index_sequence<I...>) const -> T {
+        T sum{0};
+        ((sum += a<I + 1>() * y[I]), ...);
+        return sum;
+    }
+
+    // Moves every value one older, oldest first, and puts value in front
+    template <usize N, usize... I>
+    static auto shift(std::array<T, N>& history, T const& value, std::index_sequence<I...>) -> void {
+        ((history[N - 1 - I] = history[N - 2 - I]), ...);
+        history[0] = value;
+    }
+
+  private:
+    x_history m_x{};
+    y_history m_y{};
+};
+
+// IIR filter with the coefficients of the type C, the tap counts follow
+template <typename T, typename C>
+using iir_of = iir<T, std::size(C::b), std::size(C::a), C>;
+}  // namespace nrv
@@ -2,23 +2,32 @@
  * @file   main.cpp
  * @author Pratchaya Khansomboon (pratchaya.k.git@gmail.com)
  * @brief  Pulse monitor. This project uses a lightbase heartbeat sensor on the
- *         finger tip. This implementation does not have any signal filter and
- *         calculate the BPM between every trigger point.
+ *         finger tip. The signal is band-pass filtered and the BPM estimated
+ *         from its autocorrelation over the last seconds.
  * @date   2022-03-18
  *
  * @copyright Copyright (c) 2022
  */
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <exception>
+#include <optional>
+#include <span>
 
 #include "Arduino.h"
 #include "SPI.h"
 #include "Wire.h"
 #include "Adafruit_GFX.h"
 #include "Adafruit_SSD1306.h"
-#include "driver/timer.h"
 
 #include "types.hpp"
 #include "ring.hpp"
+#include "sliding_minmax.hpp"
+#include "spsc.hpp"
+#include "heart_rate.hpp"
+#include "sos.hpp"
+#include "pulse_filters.hpp"
 #include "utils.hpp"
 
 // Hide editor error when on macOS, the clang lsp server
@@ -30,7 +39,6 @@
 
 // factor constants for time conversion
 constexpr auto ONE_SECOND_US = 1'000'000;
-constexpr auto ONE_MINUTE_S  = 60;
 
 // misc configuration
 constexpr auto PULSE_PIN = A2;
@@ -42,115 +50,83 @@ constexpr auto DRAW_PERIOD = ONE_SECOND_US / DRAW_RATE;
 
 constexpr auto TIMER_FREQUENCY = 1'000;  // Hz
 
+// heart rate estimate from the autocorrelation of the last 8 s at 100 Hz
+constexpr auto HEART_RATE_DECIMATION = 10;
+constexpr auto HEART_RATE_WINDOW     = 800;
+constexpr auto ESTIMATE_PERIOD       = ONE_SECOND_US / 4;
+constexpr nrv::f32 MIN_CONFIDENCE    = 0.5f;
+
 // OLED configurations
 constexpr auto SCREEN_ADDRESS = 0x3C;
 constexpr auto SCREEN_WIDTH   = 128;
 constexpr auto SCREEN_HEIGHT  = 32;
 
+// High- and low-pass fused into one band-pass cascade of second order
+// sections, stable in float
+nrv::sos<nrv::f32, 6> band_pass = nrv::cascade(nrv::sos<nrv::f32, 3>{nrv::high_pass_sos, nrv::high_pass_gain},
+                                               nrv::sos<nrv::f32, 3>{nrv::low_pass_sos, nrv::low_pass_gain});
+
 // Data buffer for drawing and BPM calculation
 nrv::ring<nrv::f32, 2048> data_buffer{};
+// Min and max of data_buffer, pushed alongside it
+nrv::sliding_minmax<nrv::f32, 2048> data_range{};
+// Every 10th filtered sample, the band-pass leaves nothing above 50 Hz
+nrv::ring<nrv::f32, HEART_RATE_WINDOW> heart_history{};
+// Allocates its FFT buffers, constructed in setup() where a failure can be
+// reported instead of during static initialisation
+std::optional<nrv::heart_rate<nrv::f32>> bpm_estimator{};
 // max and min threshold for pulse data trigger
 // value in percentage
 constexpr nrv::f32 min_threshold = 0.75f;
 constexpr nrv::f32 max_threshold = 0.85f;
 
+// ADC reading and the time it was taken
+struct sample {
+    nrv::i64 time;
+    nrv::i32 value;
+};
+
+// Samples from the sampling task to loop(), 256 ms at 1 kHz
+nrv::spsc<sample, 256> sample_queue{};
+// Samples the sampling task had to drop because loop() fell that far behind
+std::atomic<nrv::u32> dropped_samples{0};
+
 // timer callback data
-nrv::i32 on_time_count = 0;
-hw_timer_t* timer       = nullptr;
-portMUX_TYPE timer_mux  = portMUX_INITIALIZER_UNLOCKED;
+hw_timer_t* timer               = nullptr;
+TaskHandle_t sample_task_handle = nullptr;
 
 // pulse data
-nrv::f32 bpm_period   = 0.0f;
+nrv::heart_rate_estimate<nrv::f32> bpm_estimate{};
+nrv::i32 decimation_count = 0;
+nrv::i32 min_value    = 0;
+nrv::i32 max_value    = 0;
 
 // OLED interface
 Adafruit_SSD1306 screen(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire);
 
 // time keeping
 nrv::i64 current_time    = 0;
-nrv::i64 last_beat       = 0;
 nrv::i64 last_update     = 0;
 nrv::i64 last_draw       = 0;
 nrv::i64 last_beat_check = 0;
+nrv::i64 last_estimate   = 0;
 
-namespace nrv {
-template <typename T, std::size_t N>
-constexpr auto length_of(T (&)[N]) -> std::size_t {
-    return N;
-}
-
-auto iir_high_pass(nrv::f64 const& value) -> nrv::f32 {
-    // [Hz] Butterworth
-    // Fs    = 1000
-    // Fstop = 0.1
-    // Fpass = 0.8
-    // [dB]
-    // Astop = 80
-    // Apass = 1
-    static nrv::f64 b[] = {
-         0.9936059630099,    -4.96802981505,    9.936059630099,   -9.936059630099,
-           4.96802981505,  -0.9936059630099
-    };
-    static nrv::f64 a[] = {
-                       1,   -4.987170880032,     9.94876577478,   -9.923271718397,
-          4.948929633379,  -0.9872528097289
-    };
-    static nrv::ring<nrv::f64, length_of(b)> x{};
-    static nrv::ring<nrv::f64, length_of(a)> y{};
-
-    x.enq(value);
-
-    auto forward = 0.0;
-    for (std::size_t i = 0; i < x.capacity(); i++) {
-        forward += b[i] * x[i];
-    }
-
-    auto feedback = 0.0;
-    for (std::size_t i = 1; i < y.capacity(); i++) {
-        feedback += -a[i] * y[i - 1];
-    }
-    y.enq(forward + feedback);
-    return *y.rbegin();
+// Wakes the sampling task, the ADC driver can't be called from an interrupt
+auto IRAM_ATTR on_time() -> void {
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(sample_task_handle, &woken);
+    portYIELD_FROM_ISR(woken);
 }
 
-auto iir_low_pass(nrv::f64 const& value) -> nrv::f32 {
-    // [Hz] Butterworth
-    // Fs    = 1000
-    // Fpass = 5
-    // Fstop = 30
-    // [dB]
-    // Astop = 80
-    // Apass = 1
-    static nrv::f64 b[] = {
-        6.594578622361e-11,3.956747173417e-10,9.891867933541e-10,1.318915724472e-09,
-        9.891867933541e-10,3.956747173417e-10,6.594578622361e-11
-    };
-    static nrv::f64 a[] = {
-                     1,   -5.842652126594,    14.22559205773,   -18.47523699553,
-        13.49869991173,   -5.260796021795,   0.8543931786795
-    };
-    static nrv::ring<nrv::f64, length_of(b)> x{};
-    static nrv::ring<nrv::f64, length_of(a)> y{};
-
-    x.enq(value);
-
-    auto forward = 0.0;
-    for (std::size_t i = 0; i < x.capacity(); i++) {
-        forward += b[i] * x[i];
-    }
-
-    auto feedback = 0.0;
-    for (std::size_t i = 1; i < y.capacity(); i++) {
-        feedback += -a[i] * y[i - 1];
+// Highest priority task on the core loop() doesn't run on, one sample per
+// timer tick however long filtering and drawing take
+auto sample_task([[maybe_unused]] void* parameter) -> void {
+    for (;;) {
+        ulTaskNotifyTake(pdFALSE, portMAX_DELAY);
+        auto const time = esp_timer_get_time();
+        sample const value{time, nrv::i32(analogRead(PULSE_PIN))};
+        if (!sample_queue.push(value)) dropped_samples.fetch_add(1, std::memory_order_relaxed);
     }
-    y.enq(forward + feedback);
-    return *y.rbegin();
-}
-}
-
-auto IRAM_ATTR on_time() -> void {
-    portENTER_CRITICAL_ISR(&timer_mux);
-    on_time_count++;
-    portEXIT_CRITICAL_ISR(&timer_mux);
 }
 
 auto setup() -> void {
@@ -167,50 +143,67 @@ auto setup() -> void {
         for(;;);
     }
 
+    try {
+        bpm_estimator.emplace(nrv::f32(TIMER_FREQUENCY / HEART_RATE_DECIMATION), HEART_RATE_WINDOW);
+    } catch (std::exception const& e) {
+        Serial.println("ERROR INITIALIZING BPM ESTIMATOR!");
+        Serial.println(e.what());
+        for(;;);
+    }
+
+    // sampling task on core 0, loop() runs on core 1
+    xTaskCreatePinnedToCore(sample_task, "sample", 4096, nullptr, configMAX_PRIORITIES - 1, &sample_task_handle, 0);
+
     // setup timer interrupt callback at a fixed frequency
-    timer = timerBegin(0, 80, true);
-    timerAttachInterrupt(timer, on_time, true);
-    timerAlarmWrite(timer, ONE_SECOND_US / TIMER_FREQUENCY, true);
-    timerAlarmEnable(timer);
+    timer = timerBegin(ONE_SECOND_US);  // 1 MHz tick
+    timerAttachInterrupt(timer, on_time);
+    timerAlarm(timer, ONE_SECOND_US / TIMER_FREQUENCY, true, 0);
 }
 
-auto loop() -> void {
-    if (on_time_count < 1) return;
-    // update data
-    current_time = esp_timer_get_time();
-    portENTER_CRITICAL(&timer_mux);
-    on_time_count--;
-    portEXIT_CRITICAL(&timer_mux);
-
-    auto const read_value = analogRead(PULSE_PIN);
+// Filter one sample and look for a beat at the time it was taken
+auto update(sample const& input) -> void {
     // Apply High- and Low-pass filter to achieve bandpass
-    nrv::f32 value = nrv::iir_high_pass(nrv::f32(read_value));
-    value = nrv::iir_low_pass(value);
-    auto prev_value = *std::rbegin(data_buffer);
+    nrv::f32 const value = band_pass(nrv::f32(input.value));
+    auto prev_value = data_buffer.at_back(0);
     // add read value to data_buffer ring
     data_buffer.enq(value);
+    if (++decimation_count == HEART_RATE_DECIMATION) {
+        heart_history.enq(value);
+        decimation_count = 0;
+    }
 
     // min and max value for scaling to fit screen and BPM calculation
-    nrv::i32 min_value = INT32_MAX, max_value = INT32_MIN;
-    for (std::size_t i = 0; i < data_buffer.capacity(); i++) {
-        auto value = nrv::i32(data_buffer.at_back(i));
-        if (value > max_value) max_value = value;
-        if (value < min_value) min_value = value;
-    }
+    data_range.push(value);
+    min_value = nrv::i32(data_range.min());
+    max_value = nrv::i32(data_range.max());
 
-    // Prepare for calculating BPM
+    // Beat indicator, the BPM comes from the autocorrelation estimate
     auto const value_range     = nrv::f32(max_value);
     auto const norm_value      = (value     ) / value_range;
     auto const norm_prev_value = (prev_value) / value_range;
 
-    if (norm_prev_value < min_threshold && norm_value > min_threshold && current_time - last_beat_check > 20'000) {
-        bpm_period = float(current_time - last_beat) / static_cast<float>(ONE_SECOND_US);
-        last_beat  = current_time;
-        last_beat_check = current_time;
+    if (norm_prev_value < min_threshold && norm_value > min_threshold && input.time - last_beat_check > 20'000) {
+        last_beat_check = input.time;
         digitalWrite(LED_PIN, 1);
     } else {
         digitalWrite(LED_PIN, 0);
     }
+}
+
+auto loop() -> void {
+    // Drain the samples queued since the last call in one batch
+    std::array<sample, 64> batch{};
+    auto const count = sample_queue.pop(batch);
+    if (count == 0) return;
+    for (auto const& input : std::span<sample const>(batch).first(count)) update(input);
+    current_time = batch[count - 1].time;
+
+    // A few estimates per second, the samples cost nothing in between
+    if (current_time - last_estimate >= ESTIMATE_PERIOD) {
+        auto const [first, second] = heart_history.spans();
+        bpm_estimate  = bpm_estimator->estimate(first, second);
+        last_estimate = current_time;
+    }
 
     auto update_delta = current_time - last_update;
     last_update = current_time;
@@ -220,22 +213,28 @@ auto loop() -> void {
     screen.clearDisplay();
 
     // Draw the signal scaled to fit
-    auto it = std::rbegin(data_buffer);
-    for (auto i = 0; i < SCREEN_WIDTH; i++) {
-        if (it == std::rend(data_buffer) || min_value == max_value) break;
-        auto const y = nrv::map<nrv::i32>(nrv::i32(*it), min_value, max_value, 0, SCREEN_HEIGHT);
-        screen.drawPixel(SCREEN_WIDTH - i, y, SSD1306_WHITE);
-        it -= data_buffer.capacity() / SCREEN_WIDTH;
+    auto const draw_step = data_buffer.capacity() / SCREEN_WIDTH;
+    for (std::size_t i = 0; i < std::size_t(SCREEN_WIDTH); i++) {
+        if (i * draw_step >= data_buffer.size() || min_value == max_value) break;
+        auto const y = nrv::map<nrv::i32>(nrv::i32(data_buffer.at_back(i * draw_step)), min_value, max_value, 0,
+                                          SCREEN_HEIGHT);
+        screen.drawPixel(SCREEN_WIDTH - nrv::i32(i), y, SSD1306_WHITE);
     }
 
     // Print BPM to OLED
     screen.setCursor(0, 0);
     screen.setTextSize(1);
     screen.setTextColor(SSD1306_WHITE);
-    screen.printf("BPM:%.0f", static_cast<float>(ONE_MINUTE_S) / bpm_period);
+    if (bpm_estimate.confidence >= MIN_CONFIDENCE)
+        screen.printf("BPM:%.0f", static_cast<double>(bpm_estimate.bpm));
+    else
+        screen.printf("BPM:--");
 
     screen.display();
-    Serial.printf("frame time: %lld ms, update: %lld ms\n", (current_time - last_draw) / 1000, update_delta / 1000);
+
+    Serial.printf("frame time: %lld ms, update: %lld ms, bpm: %.1f (confidence %.2f), dropped: %lu\n",
+                  (current_time - last_draw) / 1000, update_delta / 1000, static_cast<double>(bpm_estimate.bpm),
+                  static_cast<double>(bpm_estimate.confidence),
+                  static_cast<unsigned long>(dropped_samples.load(std::memory_order_relaxed)));
     last_draw = current_time;
 }
-
@@ -0,0 +1,196 @@
+/**
+ * @file   mirrored_ring.hpp
+ * @author Pratchaya Khansomboon (pratchaya.k.git@gmail.com)
+ * @brief  Ring buffer mapped twice back to back in virtual memory, every
+ *         window of it is contiguous. Linux only.
+ * @date   2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+#include <algorithm>
+#include <cerrno>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#ifndef __linux__
+#error "mirrored_ring needs memfd_create and mmap, it's for the Linux host"
+#endif
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "types.hpp"
+
+namespace nrv {
+/**
+ * Ring buffer, FIFO, of the capacity() newest values for host side
+ * processing of long recordings. The storage is a memfd mapped twice, back
+ * to back, so index i and i + capacity() are the same memory. The values
+ * oldest to newest, and any window of them, are one contiguous span however
+ * they wrap around the storage. An FFT, FIR or STFT stage reads a window
+ * straight out of the ring, no wrap handling and no copy, and a block is
+ * enqueued with one copy.
+ *
+ * The capacity is rounded up to whole pages. T has to be trivially
+ * copyable, the values live in the shared mapping. Reading more than
+ * size() values back isn't checked, like ring.
+ */
+template <typename T>
+class mirrored_ring {
+    static_assert(std::is_trivially_copyable_v<T>, "mirrored_ring values have to be trivially copyable");
+
+  public:
+    using value_type     = T;
+    using iterator       = T*;
+    using const_iterator = T const*;
+
+    // At least capacity values, rounded up to whole pages
+    explicit mirrored_ring(usize const& capacity) {
+        if (capacity == 0)
+            throw std::invalid_argument("mirrored_ring: capacity needs to be at least 1");
+        auto const unit = std::lcm(usize(sysconf(_SC_PAGESIZE)), sizeof(T));
+        m_bytes    = (capacity * sizeof(T) + unit - 1) / unit * unit;
+        m_capacity = m_bytes / sizeof(T);
+        m_data     = map(m_bytes);
+    }
+
+    mirrored_ring(mirrored_ring const&) = delete;
+    auto operator=(mirrored_ring const&) -> mirrored_ring& = delete;
+
+    mirrored_ring(mirrored_ring&& other) noexcept
+        : m_data(std::exchange(other.m_data, nullptr)), m_bytes(std::exchange(other.m_bytes, 0)),
+          m_capacity(std::exchange(other.m_capacity, 0)), m_head(std::exchange(other.m_head, 0)),
+          m_size(std::exchange(other.m_size, 0)) {}
+
+    auto operator=(mirrored_ring&& other) noexcept -> mirrored_ring& {
+        if (this != &other) {
+            unmap();
+            m_data     = std::exchange(other.m_data, nullptr);
+            m_bytes    = std::exchange(other.m_bytes, 0);
+            m_capacity = std::exchange(other.m_capacity, 0);
+            m_head     = std::exchange(other.m_head, 0);
+            m_size     = std::exchange(other.m_size, 0);
+        }
+        return *this;
+    }
+
+    ~mirrored_ring() { unmap(); }
+
+    auto capacity() const -> usize { return m_capacity; }
+    auto size() const -> usize { return m_size; }
+    auto empty() const -> bool { return m_size == 0; }
+
+    // Append value as the newest, drops the oldest when full
+    auto enq(T const& value) -> void {
+        m_data[m_head] = value;
+        m_head = m_head + 1 == m_capacity ? 0 : m_head + 1;
+        if (m_size < m_capacity) ++m_size;
+    }
+
+    // Append a block as the newest values, one copy into the mirror
+    auto enq(std::span<T const> values) -> void {
+        if (values.size() >= m_capacity) {
+            std::copy_n(values.data() + values.size() - m_capacity, m_capacity, m_data);
+            m_head = 0;
+            m_size = m_capacity;
+            return;
+        }
+        std::copy_n(values.data(), values.size(), m_data + m_head);
+        m_head += values.size();
+        if (m_head >= m_capacity) m_head -= m_capacity;
+        m_size = std::min(m_size + values.size(), m_capacity);
+    }
+
+    // Append value as the newest, unless full
+    auto enq_keep(T const& value) -> void {
+        if (m_size == m_capacity) return;
+        enq(value);
+    }
+
+    // Remove and return the oldest value
+    auto deq() -> T {
+        auto const ret = m_data[start()];
+        if (m_size > 0) --m_size;
+        return ret;
+    }
+
+    // Value offset after the oldest
+    auto at_front(usize const& offset) const -> T const& { return m_data[start() + offset]; }
+    // Value offset before the newest
+    auto at_back(usize const& offset) const -> T const& { return m_data[start() + m_size - 1 - offset]; }
+    auto operator[](usize const& offset) const -> T const& { return at_back(offset); }
+
+    // All values, oldest to newest
+    auto values() const -> std::span<T const> { return {m_data + start(), m_size}; }
+
+    /**
+     * The length values ending lag values before the newest, oldest first,
+     * lag + length <= size(). window(0, n) are the n newest values.
+     */
+    auto window(usize const& lag, usize const& length) const -> std::span<T const> {
+        return {m_data + start() + m_size - lag - length, length};
+    }
+
+    auto begin() const -> const_iterator { return m_data + start(); }
+    auto end() const -> const_iterator { return begin() + m_size; }
+
+  private:
+    // Storage index of the oldest value, the newest is below 2 * capacity
+    auto start() const -> usize { return m_head >= m_size ? m_head - m_size : m_head + m_capacity - m_size; }
+
+    /**
+     * Reserves twice bytes of address space and maps the same memfd of
+     * bytes over both halves. Any failure releases what was set up and
+     * throws std::system_error.
+     */
+    static auto map(usize const& bytes) -> T* {
+        auto const fail = [](int const& error, char const* what) {
+            throw std::system_error(error, std::generic_category(), std::string("mirrored_ring: ") + what);
+        };
+        auto const fd = memfd_create("nrv::mirrored_ring", MFD_CLOEXEC);
+        if (fd < 0) fail(errno, "memfd_create");
+        if (ftruncate(fd, off_t(bytes)) != 0) {
+            auto const error = errno;
+            close(fd);
+            fail(error, "ftruncate");
+        }
+
+        auto* const base = static_cast<u8*>(mmap(nullptr, 2 * bytes, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+        if (base == MAP_FAILED) {
+            auto const error = errno;
+            close(fd);
+            fail(error, "mmap");
+        }
+        for (auto* const half : {base, base + bytes}) {
+            if (mmap(half, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED) {
+                auto const error = errno;
+                munmap(base, 2 * bytes);
+                close(fd);
+                fail(error, "mmap");
+            }
+        }
+        // The mappings keep the memory alive
+        close(fd);
+        return reinterpret_cast<T*>(base);
+    }
+
+    auto unmap() -> void {
+        if (m_data != nullptr) munmap(m_data, 2 * m_bytes);
+    }
+
+  private:
+    T*    m_data     = nullptr;
+    usize m_bytes    = 0;
+    usize m_capacity = 0;
+    usize m_head     = 0;  // storage index the next value is written to
+    usize m_size     = 0;
+};
+}  // namespace nrv
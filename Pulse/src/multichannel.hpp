@@ -0,0 +1,210 @@
+/**
+ * @file   multichannel.hpp
+ * @author Pratchaya Khansomboon (pratchaya.k.git@gmail.com)
+ * @brief  FIR and SOS IIR filters running C channels in lockstep with the
+ *         same coefficients, the state stored channel by channel per tap.
+ * @date   2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+#include <algorithm>
+#include <array>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include "types.hpp"
+#include "sos.hpp"
+
+namespace nrv {
+// Order of the samples of C channels in one buffer of C * frames values
+enum class channel_layout {
+    interleaved,  // in[n * C + c], one frame of all channels after the other
+    planar,       // in[c * frames + n], one channel after the other
+};
+
+namespace detail {
+/**
+ * Feeds the buffer in frame by frame through step and writes the frames it
+ * returns to out in the same layout, in and out may be the same buffer.
+ */
+template <typename T, usize C, typename Step>
+auto process_channels(std::span<T const> in, std::span<T> out, channel_layout const& layout, Step&& step,
+                      char const* error) -> void {
+    if (in.size() != out.size() || in.size() % C != 0)
+        throw std::invalid_argument(error);
+    auto const frames = in.size() / C;
+    if (layout == channel_layout::interleaved) {
+        std::array<T, C> x{};
+        for (usize n = 0; n < frames; n++) {
+            std::copy_n(in.data() + n * C, C, x.data());
+            auto const y = step(x);
+            std::copy_n(y.data(), C, out.data() + n * C);
+        }
+    } else {
+        // Transposed a few frames at a time, one frame of planar channels
+        // would touch C cache lines
+        constexpr usize chunk = 16;
+        std::array<std::array<T, C>, chunk> block{};
+        for (usize n = 0; n < frames; n += chunk) {
+            auto const count = std::min(chunk, frames - n);
+            for (usize c = 0; c < C; c++)
+                for (usize j = 0; j < count; j++) block[j][c] = in[c * frames + n + j];
+            for (usize j = 0; j < count; j++) block[j] = step(block[j]);
+            for (usize c = 0; c < C; c++)
+                for (usize j = 0; j < count; j++) out[c * frames + n + j] = block[j][c];
+        }
+    }
+}
+}  // namespace detail
+
+/**
+ * FIR filter y_c(n) = sum b[k] * x_c(n - k) of C channels with the same
+ * coefficients. The history is a delay line of frames, sample k of all
+ * channels next to each other, so a tap is one multiply-add of b[k] with a
+ * whole frame, a vector FMA across the channels when C floats fill a
+ * register (4 for SSE and NEON, 8 for AVX, 16 for AVX-512). The frames are
+ * stored twice like detail::delay_line, the history is always contiguous.
+ */
+template <typename T, usize C>
+class multichannel_fir {
+    static_assert(C > 0, "multichannel_fir needs at least one channel");
+
+  public:
+    using value_type = T;
+    using frame_type = std::array<T, C>;
+
+    explicit multichannel_fir(std::span<T const> b)
+        : m_b(std::begin(b), std::end(b)), m_line(2 * b.size(), frame_type{}) {
+        if (b.empty())
+            throw std::invalid_argument("multichannel_fir: needs at least one coefficient");
+    }
+
+    static constexpr auto channels() -> usize { return C; }
+    auto taps() const -> usize { return m_b.size(); }
+
+    auto reset() -> void {
+        std::fill(std::begin(m_line), std::end(m_line), frame_type{});
+        m_pos = 0;
+    }
+
+    // Filter one frame, sample n of every channel
+    auto operator()(frame_type const& x) -> frame_type {
+        auto const M = m_b.size();
+        m_pos = m_pos == 0 ? M - 1 : m_pos - 1;
+        m_line[m_pos] = x;
+        m_line[m_pos + M] = x;
+
+        // Four independent sums, one would wait on every multiply-add before
+        // it. Named instead of an array, so they stay in registers.
+        auto const* h = m_line.data() + m_pos;
+        frame_type s0{}, s1{}, s2{}, s3{};
+        usize k = 0;
+        for (; k + 4 <= M; k += 4) {
+            madd(s0, m_b[k], h[k]);
+            madd(s1, m_b[k + 1], h[k + 1]);
+            madd(s2, m_b[k + 2], h[k + 2]);
+            madd(s3, m_b[k + 3], h[k + 3]);
+        }
+        for (; k < M; k++) madd(s0, m_b[k], h[k]);
+
+        frame_type y;
+        for (usize c = 0; c < C; c++) y[c] = (s0[c] + s1[c]) + (s2[c] + s3[c]);
+        return y;
+    }
+
+    // Filter a block of in.size() / C frames, in and out may be the same buffer
+    auto process(std::span<T const> in, std::span<T> out,
+                 channel_layout const& layout = channel_layout::interleaved) -> void {
+        detail::process_channels<T, C>(in, out, layout, [this](frame_type const& x) { return (*this)(x); },
+                                       "multichannel_fir: sizes don't match or aren't whole frames");
+    }
+
+  private:
+    // sum += b * h, one vector multiply-add across the channels
+    static auto madd(frame_type& sum, T const& b, frame_type const& h) -> void {
+        for (usize c = 0; c < C; c++) sum[c] += b * h[c];
+    }
+
+  private:
+    std::vector<T> m_b{};
+    std::vector<frame_type> m_line{};
+    usize m_pos = 0;
+};
+
+/**
+ * Cascade of N second order sections, see sos, of C channels with the same
+ * coefficients. The two state values of a section are a frame each, every
+ * line of the transposed direct form II is one vector operation across the
+ * channels. The output of a channel is exactly that of a single sos.
+ */
+template <typename T, usize N, usize C>
+class multichannel_sos {
+    static_assert(C > 0, "multichannel_sos needs at least one channel");
+
+  public:
+    using value_type = T;
+    using frame_type = std::array<T, C>;
+
+    constexpr multichannel_sos() = default;
+
+    explicit constexpr multichannel_sos(sos<T, N> const& filter) : m_sections(filter.sections()) {}
+
+    // From MATLAB's sos matrix and gain, see sos
+    template <typename U, usize G>
+    multichannel_sos(U const (&matrix)[N][6], U const (&gain)[G]) : multichannel_sos(sos<T, N>{matrix, gain}) {}
+
+    static constexpr auto size() -> usize { return N; }
+    static constexpr auto channels() -> usize { return C; }
+
+    auto reset() -> void { m_state = {}; }
+
+    // Filter one frame, sample n of every channel
+    auto operator()(frame_type const& x) -> frame_type { return step(m_sections, m_state, x); }
+
+    /**
+     * Filter a block of in.size() / C frames, in and out may be the same
+     * buffer. The coefficients and the state are kept in locals for the
+     * block like sos::process().
+     */
+    auto process(std::span<T const> in, std::span<T> out,
+                 channel_layout const& layout = channel_layout::interleaved) -> void {
+        auto const sections = m_sections;
+        auto state = m_state;
+        detail::process_channels<T, C>(in, out, layout,
+                                       [&](frame_type const& x) { return step(sections, state, x); },
+                                       "multichannel_sos: sizes don't match or aren't whole frames");
+        m_state = state;
+    }
+
+  private:
+    using state_type = std::array<std::array<frame_type, 2>, N>;
+
+    static auto step(std::array<biquad<T>, N> const& sections, state_type& state, frame_type const& x)
+        -> frame_type {
+        // Copies of a section and its state in locals, the compiler can't
+        // tell they don't alias y and keeps the lanes scalar otherwise
+        auto y = x;
+        for (usize i = 0; i < N; i++) {
+            auto const [b0, b1, b2, a1, a2] = sections[i];
+            auto [s0, s1] = state[i];
+            auto const in = y;
+            for (usize c = 0; c < C; c++) {
+                y[c]  = b0 * in[c] + s0[c];
+                s0[c] = b1 * in[c] - a1 * y[c] + s1[c];
+                s1[c] = b2 * in[c] - a2 * y[c];
+            }
+            state[i] = {s0, s1};
+        }
+        return y;
+    }
+
+  private:
+    std::array<biquad<T>, N> m_sections{};
+    state_type m_state{};
+};
+}  // namespace nrv
@@ -0,0 +1,80 @@
+/**
+ * @file   plan_cache.hpp
+ * @author Pratchaya Khansomboon (pratchaya.k.git@gmail.com)
+ * @brief  Process wide cache of FFT plans keyed by size, for code that
+ *         doesn't keep its own plans.
+ * @date   2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+#include <complex>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "types.hpp"
+#include "fft.hpp"
+#include "rfft.hpp"
+
+namespace nrv {
+/**
+ * Process wide cache of plans keyed by size. Plans are built on the first
+ * request and live until clear() is called, the returned pointer keeps a plan
+ * alive even after it's evicted. Safe to call from multiple threads.
+ */
+template <typename Plan>
+class plan_cache {
+  public:
+    using plan_type = Plan;
+    using plan_ptr  = std::shared_ptr<plan_type const>;
+
+    static auto get(usize const& size) -> plan_ptr {
+        auto& c = instance();
+        std::lock_guard lock{c.mutex};
+        auto it = c.plans.find(size);
+        if (it != std::end(c.plans)) return it->second;
+        auto plan = std::make_shared<plan_type const>(size);
+        c.plans.emplace(size, plan);
+        return plan;
+    }
+
+    static auto clear() -> void {
+        auto& c = instance();
+        std::lock_guard lock{c.mutex};
+        c.plans.clear();
+    }
+
+    static auto count() -> usize {
+        auto& c = instance();
+        std::lock_guard lock{c.mutex};
+        return c.plans.size();
+    }
+
+  private:
+    struct storage {
+        std::mutex mutex{};
+        std::unordered_map<usize, plan_ptr> plans{};
+    };
+    static auto instance() -> storage& {
+        static storage s{};
+        return s;
+    }
+};
+
+template <typename T>
+using fft_plan_cache = plan_cache<fft_plan<T>>;
+
+template <typename T>
+using rfft_plan_cache = plan_cache<rfft_plan<T>>;
+
+// Forward FFT of the samples using the cached plan for its size
+template <typename T>
+auto fft(std::vector<std::complex<T>> const& samples) -> std::vector<std::complex<T>> {
+    return (*fft_plan_cache<T>::get(samples.size()))(samples);
+}
+}  // namespace nrv
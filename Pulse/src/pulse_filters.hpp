@@ -0,0 +1,69 @@
+/**
+ * @file   pulse_filters.hpp
+ * @author Pratchaya Khansomboon (pratchaya.k.git@gmail.com)
+ * @brief  Filter coefficients of the Pulse monitor, shared by the firmware
+ *         and the models.
+ * @date   2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+#pragma once
+#include "types.hpp"
+
+namespace nrv {
+// High-pass, removes the baseline wander
+// [Hz] Butterworth
+// Fs    = 1000
+// Fstop = 0.1
+// Fpass = 0.8
+// [dB]
+// Astop = 80
+// Apass = 1
+// 5th order, [sos, g] = zp2sos(z, p, k), rows [b0 b1 b2 a0 a1 a2]
+inline constexpr f64 high_pass_sos[3][6] = {
+    {1, -1, 0, 1, -0.9960434207322766,                  0},
+    {1, -2, 1, 1, -1.993590296675773,  0.9936059630099547},
+    {1, -2, 1, 1, -1.997537162624082,  0.9975528599741261},
+};
+inline constexpr f64 high_pass_gain[] = {0.9936059630099244};
+
+// Low-pass, keeps the heart rate band
+// [Hz] Butterworth
+// Fs    = 1000
+// Fpass = 5
+// Fstop = 30
+// [dB]
+// Astop = 80
+// Apass = 1
+// 6th order, [sos, g] = zp2sos(z, p, k), rows [b0 b1 b2 a0 a1 a2]
+inline constexpr f64 low_pass_sos[3][6] = {
+    {1, 2, 1, 1, -1.922727306697641, 0.9243228695092449},
+    {1, 2, 1, 1, -1.942421151520642, 0.9440330571419139},
+    {1, 2, 1, 1, -1.97750366837547,  0.9791446869963004},
+};
+inline constexpr f64 low_pass_gain[] = {6.594580784224924e-11};
+
+// The two filters as direct form polynomials, for iir_of, 13 significant
+// digits. The rounding already moves the high-pass poles, run them in double.
+struct high_pass_tf {
+    static constexpr f64 b[] = {
+         0.9936059630099,    -4.96802981505,    9.936059630099,   -9.936059630099,
+           4.96802981505,  -0.9936059630099
+    };
+    static constexpr f64 a[] = {
+                       1,   -4.987170880032,     9.94876577478,   -9.923271718397,
+          4.948929633379,  -0.9872528097289
+    };
+};
+
+struct low_pass_tf {
+    static constexpr f64 b[] = {
+      6.594578622361e-11,  3.956747173417e-10,  9.891867933541e-10,  1.318915724472e-09,
+      9.891867933541e-10,  3.956747173417e-10,  6.594578622361e-11
+    };
+    static constexpr f64 a[] = {
+                       1,   -5.842652126594,    14.22559205773,   -18.47523699553,
+          13.49869991173,   -5.260796021795,   0.8543931786795
+    };
+};
+}  // namespace nrv
@@ -0,0 +1,230 @@
+/**
+ * @file   resample.hpp
+ * @author Pratchaya Khansomboon (pratchaya.k.git@gmail.com)
+ * @brief  Polyphase sample rate conversion, decimation, interpolation and
+ *         rational and arbitrary ratio resampling of a sample stream.
+ * @date   2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+
+#include <algorithm>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include "types.hpp"
+#include "fir.hpp"
+
+namespace nrv {
+/**
+ * Rational resampler by up / down. The stream is, in theory, upsampled by L =
+ * up with zeros, low-pass filtered at the rate L * fs by b and downsampled by
+ * M = down. Output m is at the time t = m * M of the upsampled stream, of the
+ * filter only the coefficients b[j * L + p], p = t mod L, meet a sample that
+ * isn't a zero. So b is split into L phases of ceil(size / L) coefficients
+ * and every output is one dot product of a phase with the newest input
+ * samples, only the outputs that are kept are computed and nothing is ever
+ * multiplied with the zeros:
+ *
+ *   y(m) = L * sum_j b[j * L + p] * x(t / L - j)
+ *
+ * Decimation by M is resampler(1, M), interpolation by L resampler(L, 1), see
+ * make_decimator() and make_interpolator(). The first output is at the time
+ * of the first input sample. All the buffers are allocated by the
+ * constructor.
+ */
+template <typename T>
+class resampler {
+  public:
+    using value_type = T;
+
+    // Resampler with the coefficients b of a low-pass at the rate up * fs
+    resampler(usize const& up, usize const& down, std::span<T const> b)
+        : m_up(up), m_down(down), m_taps(b.size()) {
+        if (up == 0 || down == 0)
+            throw std::invalid_argument("resampler: up and down need to be at least 1");
+        if (b.empty())
+            throw std::invalid_argument("resampler: needs at least one coefficient");
+
+        // Phase p is row p of the bank, the coefficients b[j * L + p] times L
+        auto const K = (b.size() + up - 1) / up;
+        m_history = detail::delay_line<T>(K);
+        m_bank.assign(up * K, T(0));
+        for (usize p = 0; p < up; p++)
+            for (usize j = 0; j < K && j * up + p < b.size(); j++)
+                m_bank[p * K + j] = T(up) * b[j * up + p];
+    }
+
+    /**
+     * Resampler with a windowed sinc low-pass, cut off at 80% of the lower
+     * one of the two Nyquist frequencies. up / down is reduced first. The
+     * phases have taps_per_phase coefficients, when decimating ceil(M / L)
+     * times as many for the narrower filter.
+     */
+    resampler(usize const& up, usize const& down, usize const& taps_per_phase = 16)
+        : resampler(reduce(up, down), reduce(down, up), design(reduce(up, down), reduce(down, up), taps_per_phase)) {}
+
+    auto up() const -> usize { return m_up; }
+    auto down() const -> usize { return m_down; }
+    auto ratio() const -> f64 { return f64(m_up) / f64(m_down); }
+    auto phases() const -> usize { return m_up; }
+    auto taps() const -> usize { return m_taps; }
+
+    // Group delay of the linear phase filter in input samples
+    auto delay() const -> f64 { return f64(m_taps - 1) / (2.0 * f64(m_up)); }
+
+    // Number of outputs the next `count` input samples produce
+    auto output_size(usize const& count) const -> usize {
+        auto const end = count * m_up;
+        return m_next >= end ? 0 : (end - m_next + m_down - 1) / m_down;
+    }
+
+    auto reset() -> void {
+        m_history.reset();
+        m_next = 0;
+    }
+
+    /**
+     * Feed the input samples, write the outputs to out and return how many,
+     * out needs room for output_size(in.size()) values.
+     */
+    auto process(std::span<T const> in, std::span<T> out) -> usize {
+        if (out.size() < output_size(in.size()))
+            throw std::invalid_argument("resampler: output buffer is too small");
+        auto const K = m_history.size();
+        usize count = 0;
+        for (auto const& x : in) {
+            m_history.push(x);
+            for (; m_next < m_up; m_next += m_down)
+                out[count++] = detail::dot(m_bank.data() + m_next * K, m_history.data(), K);
+            m_next -= m_up;
+        }
+        return count;
+    }
+
+  private:
+    static auto reduce(usize const& a, usize const& b) -> usize {
+        return a == 0 || b == 0 ? a : a / std::gcd(a, b);
+    }
+
+    static auto design(usize const& L, usize const& M, usize const& taps_per_phase) -> std::vector<T> {
+        if (L == 0 || M == 0 || (L == 1 && M == 1)) return {T(1)};
+        auto const K = std::max<usize>(taps_per_phase, 1) * ((M + L - 1) / L);
+        return make_lowpass<T>(K * L, 0.4 / f64(std::max(L, M)));
+    }
+
+  private:
+    usize m_up   = 1;
+    usize m_down = 1;
+    usize m_taps = 0;
+    usize m_next = 0;  // Upsampled time of the next output from the next input
+    std::vector<T> m_bank{};
+    detail::delay_line<T> m_history{};
+};
+
+// Keeps every factor-th sample of the low-passed stream
+template <typename T>
+auto make_decimator(usize const& factor, usize const& taps_per_phase = 16) -> resampler<T> {
+    return resampler<T>(1, factor, taps_per_phase);
+}
+
+// factor output samples per input sample
+template <typename T>
+auto make_interpolator(usize const& factor, usize const& taps_per_phase = 16) -> resampler<T> {
+    return resampler<T>(factor, 1, taps_per_phase);
+}
+
+/**
+ * Resampler for any ratio fs_out / fs_in, also ones that aren't a fraction
+ * of small integers, like 1000 Hz to 64 Hz, or a ratio tracking a drifting
+ * clock. The low-pass is a windowed sinc tabulated at P phases between two
+ * input samples. An output between the phases is the linear interpolation
+ * of the dot products of the two phases around it, so it costs two dot
+ * products. The time of the next output is kept in 32.32 fixed point, the
+ * output times don't drift however long the stream runs.
+ */
+template <typename T>
+class fractional_resampler {
+  public:
+    using value_type = T;
+
+    fractional_resampler(f64 const& ratio, usize const& taps_per_phase = 16, usize const& phases = 64)
+        : m_ratio(ratio), m_phases(phases) {
+        if (!(ratio > 0.0) || taps_per_phase == 0 || phases == 0)
+            throw std::invalid_argument("fractional_resampler: needs a positive ratio, taps and phases");
+        m_step = u64(std::llround(f64(one) / ratio));
+        if (m_step == 0)
+            throw std::invalid_argument("fractional_resampler: ratio is too large");
+
+        // Decimating needs a narrower filter, longer by the same factor
+        auto const scale = std::min(1.0, ratio);
+        auto const K = taps_per_phase * usize(std::ceil(1.0 / scale));
+        auto const b = make_lowpass<f64>(K * phases + 1, 0.4 * scale / f64(phases), f64(phases));
+        m_history = detail::delay_line<T>(K);
+        m_taps = b.size();
+
+        // Row p is b[j * P + p], row P is row 0 one input sample older
+        m_bank.assign((phases + 1) * K, T(0));
+        for (usize p = 0; p <= phases; p++)
+            for (usize j = 0; j < K && j * phases + p < b.size(); j++)
+                m_bank[p * K + j] = T(b[j * phases + p]);
+    }
+
+    auto ratio() const -> f64 { return m_ratio; }
+    auto phases() const -> usize { return m_phases; }
+    auto taps() const -> usize { return m_taps; }
+
+    // Group delay of the linear phase filter in input samples
+    auto delay() const -> f64 { return f64(m_taps - 1) / (2.0 * f64(m_phases)); }
+
+    // Number of outputs the next `count` input samples produce
+    auto output_size(usize const& count) const -> usize {
+        auto const end = u64(count) * one;
+        return m_next >= end ? 0 : usize((end - m_next + m_step - 1) / m_step);
+    }
+
+    auto reset() -> void {
+        m_history.reset();
+        m_next = 0;
+    }
+
+    // Same as resampler::process()
+    auto process(std::span<T const> in, std::span<T> out) -> usize {
+        if (out.size() < output_size(in.size()))
+            throw std::invalid_argument("fractional_resampler: output buffer is too small");
+        auto const K = m_history.size();
+        usize count = 0;
+        for (auto const& x : in) {
+            m_history.push(x);
+            for (; m_next < one; m_next += m_step) {
+                auto const position = m_next * m_phases;
+                auto const p = usize(position >> fraction_bits);
+                auto const a = T(f64(position & (one - 1)) / f64(one));
+                auto const y0 = detail::dot(m_bank.data() + p * K, m_history.data(), K);
+                auto const y1 = detail::dot(m_bank.data() + (p + 1) * K, m_history.data(), K);
+                out[count++] = y0 + a * (y1 - y0);
+            }
+            m_next -= one;
+        }
+        return count;
+    }
+
+  private:
+    static constexpr u64 fraction_bits = 32;
+    static constexpr u64 one = u64{1} << fraction_bits;
+
+    f64 m_ratio    = 1.0;
+    usize m_phases = 0;
+    usize m_taps   = 0;
+    u64 m_step = one;  // Input samples per output sample
+    u64 m_next = 0;    // Time of the next output from the next input
+    std::vector<T> m_bank{};
+    detail::delay_line<T> m_history{};
+};
+}  // namespace nrv
@@ -0,0 +1,149 @@
+/**
+ * @file   rfft.hpp
+ * @author Pratchaya Khansomboon (pratchaya.k.git@gmail.com)
+ * @brief  Real input FFT. N real samples are packed into N/2 complex values,
+ *         transformed with a half size FFT and split into the N/2 + 1 bins
+ *         that aren't redundant because of the Hermitian symmetry.
+ * @date   2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+
+#include <complex>
+#include <numbers>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include "types.hpp"
+#include "fft.hpp"
+
+namespace nrv {
+/**
+ * Real to complex FFT plan for N samples, N even. The half size transform
+ * uses whichever algorithm fft_plan picks for N/2.
+ *
+ * The spectrum X of a real signal x satisfies X[N - k] = conj(X[k]), only the
+ * bins 0..N/2 carry information. The even and odd samples are packed as
+ * z[k] = x[2k] + i*x[2k + 1] and transformed with an N/2 FFT, Z = FFT(z). The
+ * even and odd spectra are then separated again with
+ *
+ *   E[k] = (Z[k] + conj(Z[N/2 - k])) / 2
+ *   O[k] = (Z[k] - conj(Z[N/2 - k])) / 2i
+ *   X[k] = E[k] + e^(-2*pi*i*k/N) * O[k]
+ *
+ * which is the last stage of the radix-2 decimation in time. Bins k and
+ * N/2 - k are computed together, so the split is done in-place in the output.
+ * Executing the plan with scratch doesn't allocate, scratch is used the same
+ * way as in fft_plan.
+ */
+template <typename T>
+class rfft_plan {
+  public:
+    using value_type   = T;
+    using complex_type = std::complex<T>;
+
+    explicit rfft_plan(usize const& size) : m_size(size), m_half(half_size(size)) {
+        auto const M = m_size / 2;
+        m_twiddles.reserve(M / 2 + 1);
+        for (usize k = 0; k <= M / 2; k++) {
+            auto const angle = -2.0 * std::numbers::pi * f64(k) / f64(m_size);
+            m_twiddles.emplace_back(T(std::cos(angle)), T(std::sin(angle)));
+        }
+    }
+
+    auto size() const -> usize { return m_size; }
+    auto bins() const -> usize { return m_size / 2 + 1; }
+    auto scratch_size() const -> usize { return m_half.scratch_size(); }
+
+    // Forward transform, allocates the scratch if the half size plan needs any
+    auto execute(std::span<T const> in, std::span<complex_type> out) const -> void {
+        if (scratch_size() == 0) return execute(in, out, {});
+        std::vector<complex_type> scratch(scratch_size());
+        execute(in, out, scratch);
+    }
+
+    // Forward transform of size() real samples into bins() complex values
+    auto execute(std::span<T const> in, std::span<complex_type> out,
+                 std::span<complex_type> scratch) const -> void {
+        if (in.size() != m_size || out.size() != bins())
+            throw std::invalid_argument("rfft_plan: buffer sizes don't match the plan");
+        auto const M = m_size / 2;
+
+        for (usize k = 0; k < M; k++)
+            out[k] = {in[2 * k], in[2 * k + 1]};
+        m_half.execute(out.first(M), out.first(M), scratch);
+
+        auto const z0 = out[0];
+        out[0] = {z0.real() + z0.imag(), T(0)};
+        out[M] = {z0.real() - z0.imag(), T(0)};
+
+        for (usize k = 1; k <= M - k; k++) {
+            auto const a = out[k];
+            auto const b = std::conj(out[M - k]);
+            auto const e = (a + b) * T(0.5);
+            auto const o = detail::cmul(complex_type{T(0), T(-0.5)}, a - b);
+            auto const z = detail::cmul(m_twiddles[k], o);
+            out[k]     = e + z;
+            out[M - k] = std::conj(e - z);
+        }
+    }
+
+    // Inverse transform, allocates the scratch if the half size plan needs any
+    auto inverse(std::span<complex_type const> in, std::span<T> out) const -> void {
+        if (scratch_size() == 0) return inverse(in, out, {});
+        std::vector<complex_type> scratch(scratch_size());
+        inverse(in, out, scratch);
+    }
+
+    /**
+     * Inverse transform of bins() complex values into size() real samples,
+     * normalised so that the inverse of the forward transform returns the
+     * original samples. The imaginary parts of bin 0 and N/2 are ignored.
+     */
+    auto inverse(std::span<complex_type const> in, std::span<T> out,
+                 std::span<complex_type> scratch) const -> void {
+        if (in.size() != bins() || out.size() != m_size)
+            throw std::invalid_argument("rfft_plan: buffer sizes don't match the plan");
+        auto const M = m_size / 2;
+
+        // std::complex<T> is layout compatible with T[2], the N real outputs
+        // are used as the N/2 complex values of the packed transform.
+        auto z = std::span<complex_type>(reinterpret_cast<complex_type*>(out.data()), M);
+
+        auto const x0 = in[0].real();
+        auto const xm = in[M].real();
+        z[0] = {(x0 + xm) * T(0.5), (x0 - xm) * T(0.5)};
+
+        for (usize k = 1; k <= M - k; k++) {
+            auto const a = in[k];
+            auto const b = std::conj(in[M - k]);
+            auto const e = (a + b) * T(0.5);
+            auto const o = detail::cmul(std::conj(m_twiddles[k]), (a - b) * T(0.5));
+            auto const io = complex_type{-o.imag(), o.real()};
+            z[k]     = e + io;
+            z[M - k] = std::conj(e - io);
+        }
+
+        m_half.inverse(z, z, scratch);
+        auto const scale = T(1) / T(M);
+        for (auto& v : out) v *= scale;
+    }
+
+  private:
+    static auto half_size(usize const& size) -> usize {
+        if (size < 2 || size % 2 != 0)
+            throw std::invalid_argument("rfft_plan: size needs to be even and at least 2");
+        return size / 2;
+    }
+
+  private:
+    usize m_size = 0;
+    fft_plan<T> m_half;
+    std::vector<complex_type> m_twiddles{};
+};
+}  // namespace nrv
@@ -9,14 +9,35 @@
 #pragma once
 
 #include <cstdint>
+#include <cstddef>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <compare>
 #include <iterator>
-#include <iostream>
+#include <span>
 
 namespace nrv {
-// Fixed size ring buffer, FIFO
+/**
+ * Fixed size ring buffer, FIFO, of the SIZE newest values. The values are
+ * stored oldest to newest in increasing addresses with wrap around, so the
+ * contents are at most two contiguous runs, see spans().
+ *
+ * No index is reduced with a modulo. When SIZE is a power of two an index
+ * wraps with a mask, otherwise with a compare and subtract, every index
+ * stays below twice the capacity.
+ */
 template <typename T, std::size_t SIZE>
 class ring {
+    static_assert(SIZE > 0, "ring needs room for at least one value");
+
   public:
+    /**
+     * Random access iterator from the oldest value, begin(), to one past the
+     * newest, end(). It holds the logical position, 0 the oldest, so the
+     * distance between two iterators and their order are O(1).
+     */
     template <typename pointer_type, typename reference_type>
     struct iterator_base {
         using iterator_category = std::random_access_iterator_tag;
@@ -25,15 +46,22 @@ class ring {
         using pointer           = pointer_type;
         using reference         = reference_type;
 
-        constexpr iterator_base(pointer buffer, std::size_t const& ptr,
-                                std::size_t const& max, std::size_t const& end)
-            : m_buffer(buffer), m_ptr(ptr), m_max(max), m_end(end) {}
+        constexpr iterator_base() = default;
+        constexpr iterator_base(pointer buffer, std::size_t const& tail, difference_type const& index)
+            : m_buffer(buffer), m_tail(tail), m_index(index) {}
+        // iterator to const_iterator
+        template <typename P, typename R>
+        constexpr iterator_base(iterator_base<P, R> const& other)
+            : m_buffer(other.m_buffer), m_tail(other.m_tail), m_index(other.m_index) {}
 
-        constexpr auto operator*() const -> reference { return m_buffer[m_ptr]; }
-        constexpr auto operator->() -> pointer { return &m_buffer[m_ptr]; }
+        constexpr auto operator*() const -> reference { return m_buffer[position(m_index)]; }
+        constexpr auto operator->() const -> pointer { return &m_buffer[position(m_index)]; }
+        constexpr auto operator[](difference_type const& n) const -> reference {
+            return m_buffer[position(m_index + n)];
+        }
 
         constexpr auto operator++() -> iterator_base& {    // prefix increment
-            m_ptr = (m_ptr + m_max - 1) % m_max;
+            ++m_index;
             return *this;
         }
         constexpr auto operator++(int) -> iterator_base {  // postfix increment
@@ -42,16 +70,9 @@ class ring {
             return tmp;
         }
 
-        constexpr friend auto operator==(iterator_base const& a, iterator_base const& b) -> bool {
-            return a.m_ptr == b.m_ptr;
-        }
-        constexpr friend auto operator!=(iterator_base const& a, iterator_base const& b) -> bool {
-            return !(a == b);
-        }
-
         // bidirectional iterator requirements
         constexpr auto operator--() -> iterator_base& {
-            m_ptr = (m_ptr + 1) % m_max;
+            --m_index;
             return *this;
         }
         constexpr auto operator--(int) -> iterator_base {
@@ -62,74 +83,47 @@ class ring {
 
         // random access iterator requirements
         constexpr auto operator+=(difference_type const& n) -> iterator_base& {
-            if ((n > 0 && n > difference_type(m_max - 1)) ||
-                (n < 0 && -n > difference_type(m_max - 1)))  // sets the iterator to end iterator
-                m_ptr = (m_ptr + m_max + m_max - 1) % m_max;
-            else                                                        // do normal addition with wrap
-                m_ptr = (m_ptr + m_max + n) % m_max;
+            m_index += n;
             return *this;
         }
-
-        constexpr auto operator+(difference_type const& n) -> iterator_base {
-            if ((n > 0 && n > m_max - 1) || (n < 0 && -n > m_max - 1))  // sets the iterator to end iterator
-                m_ptr = (m_ptr + m_max + m_max - 1) % m_max;
-            else                                                        // do normal addition with wrap
-                m_ptr = (m_ptr + m_max + n) % m_max;
-            return *this;
-        }
-        constexpr auto operator-(difference_type const& n) -> iterator_base {
-            return (*this) + (-n);
-        }
-
         constexpr auto operator-=(difference_type const& n) -> iterator_base& {
-            return (*this) += (-n);
+            m_index -= n;
+            return *this;
         }
 
-        constexpr friend auto operator-(iterator_base const& a, iterator_base const& b) -> difference_type {
-            // calcuate the distance to the end iterator
-            auto a_end = a.dist_to_end();
-            auto b_end = b.dist_to_end();
-            return a_end - b_end;
+        constexpr friend auto operator+(iterator_base it, difference_type const& n) -> iterator_base {
+            return it += n;
         }
-
-        constexpr auto operator[](difference_type const& n) -> reference {
-            if ((n > 0 && n > m_max - 1) || (n < 0 && -n > m_max - 1)) // offset the pointer with wrap
-                return m_buffer[(m_ptr + m_max + n) % m_max];
-            else                                                       // deference the unused part of the memory,
-                return m_buffer[(m_ptr + m_max + m_max - 1) % m_max];  // i.e the place where end iterator is pointed at
+        constexpr friend auto operator+(difference_type const& n, iterator_base it) -> iterator_base {
+            return it += n;
         }
-
-        constexpr friend auto operator<(iterator_base const& a, iterator_base const& b) -> bool {
-            return b - a > 0;
+        constexpr friend auto operator-(iterator_base it, difference_type const& n) -> iterator_base {
+            return it -= n;
         }
-        constexpr friend auto operator>(iterator_base const& a, iterator_base const& b) -> bool {
-            return b < a;
+        constexpr friend auto operator-(iterator_base const& a, iterator_base const& b) -> difference_type {
+            return a.m_index - b.m_index;
         }
-        constexpr friend auto operator>=(iterator_base const& a, iterator_base const& b) -> bool {
-            return !(a < b);
+
+        constexpr friend auto operator==(iterator_base const& a, iterator_base const& b) -> bool {
+            return a.m_index == b.m_index;
         }
-        constexpr friend auto operator<=(iterator_base const& a, iterator_base const& b) -> bool {
-            return !(a > b);
+        constexpr friend auto operator<=>(iterator_base const& a, iterator_base const& b) -> std::strong_ordering {
+            return a.m_index <=> b.m_index;
         }
 
-        constexpr auto ptr() const -> std::size_t { return m_ptr; };
       private:
-        // FIXME: Find a better way to get the distance from the current ptr to the end, O(n)
-        auto dist_to_end() const -> difference_type {
-            auto start = m_ptr;
-            auto dist = 0;
-            while(start != m_end) {
-                dist++;
-                start = (start + m_max - 1) % m_max;
-            }
-            return dist;
+        // Storage index of the logical position index, 0 <= index < SIZE
+        constexpr auto position(difference_type const& index) const -> std::size_t {
+            return ring::wrap(m_tail + std::size_t(index));
         }
 
+        template <typename P, typename R>
+        friend struct iterator_base;
+
       private:
-        pointer     m_buffer;
-        std::size_t m_ptr;
-        std::size_t m_max;
-        std::size_t m_end;
+        pointer         m_buffer = nullptr;
+        std::size_t     m_tail   = 0;
+        difference_type m_index  = 0;
     };
 
     using iterator       = iterator_base<T*, T&>;
@@ -137,41 +131,40 @@ class ring {
     using reverse_iterator       = std::reverse_iterator<iterator>;
     using const_reverse_iterator = std::reverse_iterator<const_iterator>;
 
-    auto begin() -> iterator { return iterator(m_buffer, m_tail, m_max, m_head); }
-    auto end()   -> iterator {
-        auto const e = m_head == m_tail ? (m_head + 1) % m_max : m_head;
-        return iterator(m_buffer, e, m_max, e);
-    }
-    auto begin() const -> const_iterator { return const_iterator(m_buffer, m_tail, m_max, m_head); }
-    auto end()   const -> const_iterator { 
-        auto const e = m_head == m_tail ? (m_head + 1) % m_max : m_head;
-        return const_iterator(m_buffer, e, m_max, e);
-    }
+    auto begin() -> iterator { return iterator(m_buffer.data(), m_tail, 0); }
+    auto end()   -> iterator { return iterator(m_buffer.data(), m_tail, std::ptrdiff_t(m_size)); }
+    auto begin() const -> const_iterator { return const_iterator(m_buffer.data(), m_tail, 0); }
+    auto end()   const -> const_iterator { return const_iterator(m_buffer.data(), m_tail, std::ptrdiff_t(m_size)); }
     auto cbegin() const -> const_iterator { return begin(); }
     auto cend()   const -> const_iterator { return end();   }
 
     auto rbegin() -> reverse_iterator { return reverse_iterator(end()); }
     auto rend()   -> reverse_iterator { return reverse_iterator(begin()); }
-    auto crbegin() const -> const_reverse_iterator { return const_reverse_iterator(cend()); }
-    auto crend()   const -> const_reverse_iterator { return const_reverse_iterator(cbegin()); }
+    auto rbegin() const -> const_reverse_iterator { return const_reverse_iterator(end()); }
+    auto rend()   const -> const_reverse_iterator { return const_reverse_iterator(begin()); }
+    auto crbegin() const -> const_reverse_iterator { return rbegin(); }
+    auto crend()   const -> const_reverse_iterator { return rend(); }
 
   public:
+    // Append value as the newest, drops the oldest when full
     auto enq(T const& value) -> void {
+        m_head = ring::wrap(m_head + 1);
         m_buffer[m_head] = value;
-        m_head = ring::dec_wrap(m_head, m_max);
-        if (m_head == m_tail)
-            m_tail = ring::dec_wrap(m_tail, m_max);
-        if (m_size < m_max)
+        if (m_size < SIZE)
             ++m_size;
+        else
+            m_tail = ring::wrap(m_tail + 1);
     }
+    // Append value as the newest, unless full
     auto enq_keep(T const& value) -> void {
-        if (m_size == m_max - 1) return;
+        if (m_size == SIZE) return;
         enq(value);
     }
+    // Remove and return the oldest value
     auto deq() -> T {
         auto const ret = m_buffer[m_tail];
-        if (m_tail != m_head) {
-            m_tail = ring::dec_wrap(m_tail, m_max);
+        if (m_size > 0) {
+            m_tail = ring::wrap(m_tail + 1);
             --m_size;
         }
         return ret;
@@ -179,14 +172,31 @@ class ring {
 
     constexpr auto capacity() const -> std::size_t { return SIZE; }
     auto size() const -> std::size_t { return m_size; }
-    auto back() -> T { return m_buffer[m_tail]; }
-    auto front() -> T { return m_buffer[(m_head + 1) % m_max]; }
+    auto back() -> T { return m_buffer[m_tail]; }   // oldest
+    auto front() -> T { return m_buffer[m_head]; }  // newest
+
+    /**
+     * The values oldest to newest as two contiguous runs, the second empty
+     * unless the values wrap around the end of the storage. A kernel can run
+     * over both instead of indexing through the ring value by value. The
+     * spans are valid until the next enq() or deq().
+     */
+    auto spans() -> std::array<std::span<T>, 2> {
+        auto const first = std::min(m_size, SIZE - m_tail);
+        return {std::span<T>(m_buffer.data() + m_tail, first), std::span<T>(m_buffer.data(), m_size - first)};
+    }
+    auto spans() const -> std::array<std::span<T const>, 2> {
+        auto const first = std::min(m_size, SIZE - m_tail);
+        return {std::span<T const>(m_buffer.data() + m_tail, first),
+                std::span<T const>(m_buffer.data(), m_size - first)};
+    }
 
     using ref_type       = T&;
     using const_ref_type = T const&;
     auto operator[](std::size_t const& offset) -> ref_type { return at_back(offset); }
     auto operator[](std::size_t const& offset) const -> const_ref_type { return at_back(offset); }
 
+    // Value offset after the oldest, offset < capacity()
     auto at_front(std::size_t const& offset) -> ref_type {
         return m_buffer[index_front(offset)];
     }
@@ -194,6 +204,7 @@ class ring {
         return m_buffer[index_front(offset)];
     }
 
+    // Value offset before the newest, offset < capacity()
     auto at_back(std::size_t const& offset) -> ref_type {
         return m_buffer[index_back(offset)];
     }
@@ -202,27 +213,25 @@ class ring {
     }
 
     auto index_front(std::size_t const& offset) const -> std::size_t {
-        return (m_tail + m_max - offset) % m_max;
+        return ring::wrap(m_tail + offset);
     }
     auto index_back(std::size_t const& offset) const -> std::size_t {
-        auto index = m_size == 0 ? m_head : m_head + 1;
-        return (index + m_max + offset) % m_max;
+        return ring::wrap(m_head + SIZE - offset);
     }
 
   private:
-    static auto inc_wrap(std::size_t const& value, std::size_t const& max) -> std::size_t {
-        return (value + 1) % max;
-    }
-    static auto dec_wrap(std::size_t const& value, std::size_t const& max) -> std::size_t {
-        return (value + max - 1) % max;
+    // value mod SIZE for value < 2 * SIZE
+    static constexpr auto wrap(std::size_t const& value) -> std::size_t {
+        if constexpr (std::has_single_bit(SIZE))
+            return value & (SIZE - 1);
+        else
+            return value >= SIZE ? value - SIZE : value;
     }
 
   private:
-    T           m_buffer[SIZE + 1];  // allocate extra space for end iterator
-    std::size_t m_max   = SIZE + 1;
-    std::size_t m_head  = 0;
-    std::size_t m_tail  = 0;
+    std::array<T, SIZE> m_buffer{};
+    std::size_t m_head  = SIZE - 1;  // newest value
+    std::size_t m_tail  = 0;         // oldest value
     std::size_t m_size  = 0;
 };
 }  // namespace nrv
-
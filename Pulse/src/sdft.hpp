@@ -0,0 +1,121 @@
+/**
+ * @file   sdft.hpp
+ * @author Pratchaya Khansomboon (pratchaya.k.git@gmail.com)
+ * @brief  Sliding DFT, a few bins of an N sample window updated in O(1) per
+ *         bin for every new sample.
+ * @date   2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+
+#include <array>
+#include <complex>
+#include <numbers>
+
+#include "types.hpp"
+#include "ring.hpp"
+
+namespace nrv {
+/**
+ * Modulated sliding DFT (mSDFT) of K bins over a window of the last N samples.
+ *
+ * The textbook SDFT X_k(n) = (X_k(n - 1) + x(n) - x(n - N)) * e^(2*pi*i*k/N)
+ * has its pole on the unit circle at the rounded twiddle, so the error grows
+ * without bound. The mSDFT keeps the twiddle out of the recursion. Every bin
+ * accumulates the samples rotated by their absolute index
+ *
+ *   y_k(n) = r * y_k(n - 1) + (x(n) - r^N * x(n - N)) * e^(-2*pi*i*k*n/N)
+ *
+ * and the bin of the window ending at sample n is the accumulator rotated
+ * back, X_k(n) = e^(2*pi*i*k*(n + 1)/N) * y_k(n). The rotation only needs the
+ * table e^(-2*pi*i*m/N), indexed by k*n mod N, which is kept per bin by adding
+ * k every sample. With the damping r = 1 this is the exact DFT of the window
+ * and the rounding error only accumulates as a random walk. r slightly below
+ * 1 weights the window exponentially and bounds the error for streams that
+ * run for days.
+ *
+ * Everything has a fixed size, no allocation, so it runs on the Pulse.
+ */
+template <typename T, usize N, usize K>
+class sdft {
+    static_assert(N > 0 && K > 0, "sdft needs a window and at least one bin");
+
+  public:
+    using value_type   = T;
+    using complex_type = std::complex<T>;
+
+    explicit sdft(std::array<usize, K> const& bins, T const& damping = T(1))
+        : m_bins(bins), m_damping(damping), m_damping_n(T(std::pow(f64(damping), f64(N)))) {
+        for (usize m = 0; m < N; m++) {
+            auto const angle = -2.0 * std::numbers::pi * f64(m) / f64(N);
+            m_twiddles[m] = {T(std::cos(angle)), T(std::sin(angle))};
+        }
+        for (auto& k : m_bins) k %= N;
+    }
+
+    static constexpr auto window() -> usize { return N; }
+    static constexpr auto size() -> usize { return K; }
+
+    // Bin index of the tracked bin i
+    auto bin_index(usize const& i) const -> usize { return m_bins[i]; }
+
+    // Frequency of the tracked bin i for the sample rate fs
+    auto frequency(usize const& i, T const& fs) const -> T {
+        return T(m_bins[i]) * fs / T(N);
+    }
+
+    // Start over with an empty (all zero) window
+    auto reset() -> void {
+        m_state.fill(complex_type{});
+        m_phase.fill(0);
+    }
+
+    /**
+     * Slide the window one sample: newest enters it and oldest, the sample
+     * N samples before newest, leaves it. Zero for the first N samples.
+     */
+    auto update(T const& newest, T const& oldest) -> void {
+        auto const delta = newest - m_damping_n * oldest;
+        for (usize i = 0; i < K; i++) {
+            m_state[i] = m_damping * m_state[i] + delta * m_twiddles[m_phase[i]];
+            m_phase[i] += m_bins[i];
+            if (m_phase[i] >= N) m_phase[i] -= N;
+        }
+    }
+
+    // Slide the window after a sample was enqueued to the ring, which needs
+    // room for the window and the sample leaving it
+    template <typename S, usize SIZE>
+    auto update(ring<S, SIZE> const& samples) -> void {
+        static_assert(SIZE > N, "the ring has to hold N + 1 samples");
+        auto const oldest = samples.size() > N ? T(samples.at_back(N)) : T(0);
+        update(T(samples.at_back(0)), oldest);
+    }
+
+    // DFT bin of the tracked bin i over the window ending at the newest sample
+    auto operator[](usize const& i) const -> complex_type {
+        // The phase is k * (n + 1) mod N, conj of the table rotates forward
+        auto const w = std::conj(m_twiddles[m_phase[i]]);
+        auto const& y = m_state[i];
+        return {y.real() * w.real() - y.imag() * w.imag(),
+                y.real() * w.imag() + y.imag() * w.real()};
+    }
+
+    // |X|^2 of the tracked bin i, the accumulator has the same magnitude
+    auto power(usize const& i) const -> T {
+        return std::norm(m_state[i]);
+    }
+
+  private:
+    std::array<complex_type, N> m_twiddles{};
+    std::array<usize, K>        m_bins{};
+    std::array<complex_type, K> m_state{};
+    std::array<usize, K>        m_phase{};
+    T m_damping   = T(1);
+    T m_damping_n = T(1);
+};
+}  // namespace nrv
@@ -0,0 +1,112 @@
+/**
+ * @file   sliding_minmax.hpp
+ * @author Pratchaya Khansomboon (pratchaya.k.git@gmail.com)
+ * @brief  Minimum and maximum of the last SIZE samples of a stream in O(1)
+ *         amortised time per sample.
+ * @date   2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+#include <array>
+#include <bit>
+#include <functional>
+
+#include "types.hpp"
+
+namespace nrv {
+namespace detail {
+/**
+ * Candidates for the extreme of a window, oldest first, each one better than
+ * every later one by Compare. A new sample removes the candidates from the
+ * back it beats, they can't be the extreme again while it is in the window,
+ * and the front leaves once it is older than the window. Every sample is
+ * added and removed once. A fixed size deque of at most SIZE entries,
+ * wrapped like ring.
+ */
+template <typename T, usize SIZE, typename Compare>
+class monotonic_deque {
+  public:
+    // Sample index of the stream, one more than the last, wrapping around
+    auto push(usize const& index, T const& value) -> void {
+        // The oldest leaves the window of the SIZE newest, first so at most
+        // SIZE - 1 candidates are left for the new one
+        if (m_count > 0 && index - m_indices[m_front] >= SIZE) {
+            m_front = wrap(m_front + 1);
+            m_count--;
+        }
+        while (m_count > 0 && !Compare{}(m_values[back()], value)) m_count--;
+        auto const slot = wrap(m_front + m_count);
+        m_indices[slot] = index;
+        m_values[slot]  = value;
+        m_count++;
+    }
+
+    auto front() const -> T const& { return m_values[m_front]; }
+
+    auto reset() -> void {
+        m_front = 0;
+        m_count = 0;
+    }
+
+  private:
+    auto back() const -> usize { return wrap(m_front + m_count - 1); }
+
+    // value mod SIZE for value < 2 * SIZE
+    static constexpr auto wrap(usize const& value) -> usize {
+        if constexpr (std::has_single_bit(SIZE))
+            return value & (SIZE - 1);
+        else
+            return value >= SIZE ? value - SIZE : value;
+    }
+
+  private:
+    std::array<usize, SIZE> m_indices{};
+    std::array<T, SIZE> m_values{};
+    usize m_front = 0;
+    usize m_count = 0;
+};
+}  // namespace detail
+
+/**
+ * Minimum and maximum of the last SIZE values pushed, the window of a ring
+ * of the same size when pushed alongside its enq(). A push is O(1)
+ * amortised, at most SIZE candidates are dropped at once, instead of a scan
+ * of the whole window for every sample. Before the first push min() and
+ * max() are T{}.
+ */
+template <typename T, usize SIZE>
+class sliding_minmax {
+    static_assert(SIZE > 0, "sliding_minmax needs a window of at least one value");
+
+  public:
+    using value_type = T;
+
+    static constexpr auto window() -> usize { return SIZE; }
+    // Values in the window, up to SIZE
+    auto size() const -> usize { return m_pushed < SIZE ? m_pushed : SIZE; }
+
+    auto push(T const& value) -> void {
+        m_min.push(m_pushed, value);
+        m_max.push(m_pushed, value);
+        m_pushed++;
+    }
+
+    auto min() const -> T const& { return m_min.front(); }
+    auto max() const -> T const& { return m_max.front(); }
+
+    auto reset() -> void {
+        m_min.reset();
+        m_max.reset();
+        m_pushed = 0;
+    }
+
+  private:
+    detail::monotonic_deque<T, SIZE, std::less<T>>    m_min{};
+    detail::monotonic_deque<T, SIZE, std::greater<T>> m_max{};
+    usize m_pushed = 0;
+};
+}  // namespace nrv
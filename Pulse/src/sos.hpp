@@ -0,0 +1,143 @@
+/**
+ * @file   sos.hpp
+ * @author Pratchaya Khansomboon (pratchaya.k.git@gmail.com)
+ * @brief  IIR filter as a cascade of second order sections (biquads) in
+ *         transposed direct form II, built from MATLAB's sos and gain.
+ * @date   2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+#include <array>
+#include <span>
+#include <stdexcept>
+
+#include "types.hpp"
+
+namespace nrv {
+// Second order section, a0 normalised to 1
+template <typename T>
+struct biquad {
+    T b0 = T(1), b1 = T(0), b2 = T(0);
+    T a1 = T(0), a2 = T(0);
+};
+
+/**
+ * IIR filter of N second order sections. A high order direct form polynomial
+ * has its poles clustered close to the unit circle, e.g. the 0.8 Hz high-pass
+ * at 1 kHz, and rounding its coefficients moves the poles far enough that
+ * the filter needs double or becomes unstable. Factored into biquads every
+ * section only holds one pole pair and keeps its accuracy in float.
+ *
+ * Every section runs in transposed direct form II, two state values:
+ *
+ *   y  = b0 * x + s1
+ *   s1 = b1 * x - a1 * y + s2
+ *   s2 = b2 * x - a2 * y
+ *
+ * The coefficients come straight from MATLAB, [sos, g] = tf2sos(b, a) or the
+ * SOS matrix and scale values of a filter designed with fdatool/designfilt.
+ * Every row of the N x 6 matrix is [b0 b1 b2 a0 a1 a2]. The gain is either a
+ * single overall gain, one per section, or the N + 1 scale values where the
+ * last one is applied to the output. The gains are folded into the numerators,
+ * a first order section is a row with b2 = a2 = 0.
+ *
+ * Fixed size and no allocation, so it runs on the Pulse.
+ */
+template <typename T, usize N>
+class sos {
+    static_assert(N > 0, "sos needs at least one section");
+
+  public:
+    using value_type   = T;
+    using section_type = biquad<T>;
+
+    constexpr sos() = default;
+
+    explicit constexpr sos(std::array<section_type, N> const& sections) : m_sections(sections) {}
+
+    template <typename U, usize G>
+    sos(U const (&matrix)[N][6], U const (&gain)[G]) {
+        static_assert(G == 1 || G == N || G == N + 1,
+                      "the gain is overall, per section or the N + 1 scale values");
+        for (usize i = 0; i < N; i++) {
+            auto const& row = matrix[i];
+            if (row[3] == U(0))
+                throw std::invalid_argument("sos: a0 of a section can't be 0");
+            auto g = f64(G == 1 ? (i == 0 ? gain[0] : U(1)) : gain[i]);
+            if (G == N + 1 && i == N - 1) g *= f64(gain[N]);
+            auto const a0 = f64(row[3]);
+            m_sections[i] = {T(g * f64(row[0]) / a0), T(g * f64(row[1]) / a0), T(g * f64(row[2]) / a0),
+                             T(f64(row[4]) / a0), T(f64(row[5]) / a0)};
+        }
+    }
+
+    template <typename U>
+    explicit sos(U const (&matrix)[N][6]) : sos(matrix, {U(1)}) {}
+
+    static constexpr auto size() -> usize { return N; }
+    constexpr auto sections() const -> std::array<section_type, N> const& { return m_sections; }
+
+    auto reset() -> void { m_state.fill({}); }
+
+    auto operator()(T const& x) -> T {
+        auto y = x;
+        for (usize i = 0; i < N; i++) {
+            auto const& c = m_sections[i];
+            auto& s = m_state[i];
+            auto const in = y;
+            y    = c.b0 * in + s[0];
+            s[0] = c.b1 * in - c.a1 * y + s[1];
+            s[1] = c.b2 * in - c.a2 * y;
+        }
+        return y;
+    }
+
+    /**
+     * Filter a block, in and out may be the same buffer. The coefficients
+     * and the state are copied into locals for the block, so they stay in
+     * registers instead of being loaded and stored for every sample. The
+     * sections still run sample by sample, section i + 1 of a sample overlaps
+     * with section i of the next one, one section over the whole block would
+     * wait on its own recursion.
+     */
+    auto process(std::span<T const> in, std::span<T> out) -> void {
+        if (in.size() != out.size())
+            throw std::invalid_argument("sos: input and output sizes don't match");
+        auto const sections = m_sections;
+        auto state = m_state;
+        for (usize n = 0; n < in.size(); n++) {
+            auto y = in[n];
+            for (usize i = 0; i < N; i++) {
+                auto const& c = sections[i];
+                auto& s = state[i];
+                auto const x = y;
+                y    = c.b0 * x + s[0];
+                s[0] = c.b1 * x - c.a1 * y + s[1];
+                s[1] = c.b2 * x - c.a2 * y;
+            }
+            out[n] = y;
+        }
+        m_state = state;
+    }
+
+  private:
+    std::array<section_type, N> m_sections{};
+    std::array<std::array<T, 2>, N> m_state{};
+};
+
+/**
+ * The two filters fused into one cascade, first then second, e.g. a high-pass
+ * and a low-pass into a band-pass run in a single pass over the sections.
+ */
+template <typename T, usize N, usize M>
+constexpr auto cascade(sos<T, N> const& first, sos<T, M> const& second) -> sos<T, N + M> {
+    std::array<biquad<T>, N + M> sections{};
+    for (usize i = 0; i < N; i++) sections[i] = first.sections()[i];
+    for (usize i = 0; i < M; i++) sections[N + i] = second.sections()[i];
+    return sos<T, N + M>{sections};
+}
+}  // namespace nrv
@@ -0,0 +1,130 @@
+/**
+ * @file   spsc.hpp
+ * @author Pratchaya Khansomboon (pratchaya.k.git@gmail.com)
+ * @brief  Wait-free single producer, single consumer queue to hand samples
+ *         from the sampling side to the processing loop.
+ * @date   2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <span>
+
+#include "types.hpp"
+
+namespace nrv {
+/**
+ * Fixed size FIFO between exactly one producer and one consumer, which may
+ * run on different cores or the producer in an interrupt. Neither side
+ * locks or waits, every call finishes in a bounded number of steps. The
+ * storage is a power of two sized ring indexed with a mask like ring, but a
+ * full queue never overwrites, push() fails instead.
+ *
+ * m_head counts the pushed values and is only written by the producer,
+ * m_tail the popped values and is only written by the consumer. Both count
+ * up and wrap around, head - tail is the size. A push stores the value
+ * before it publishes it with a release store of m_head, the acquire load
+ * of the consumer sees it, pop() frees room the same way through m_tail.
+ * Each index and the copy of the other side's index its owner keeps are on
+ * their own cache line, the other side's index is only loaded again when
+ * the queue looks full or empty, so a push or a pop usually touches no line
+ * the other core writes.
+ */
+template <typename T, usize SIZE>
+class spsc {
+    static_assert(SIZE > 0 && std::has_single_bit(SIZE), "spsc capacity has to be a power of two");
+
+  public:
+    using value_type = T;
+
+    static constexpr auto capacity() -> usize { return SIZE; }
+
+    // Producer: append value, false when full
+    auto push(T const& value) -> bool {
+        auto const head = m_head.load(std::memory_order_relaxed);
+        if (head - m_tail_cache == SIZE) {
+            m_tail_cache = m_tail.load(std::memory_order_acquire);
+            if (head - m_tail_cache == SIZE) return false;
+        }
+        m_buffer[head & mask] = value;
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Producer: append as many values as fit, returns how many
+    auto push(std::span<T const> values) -> usize {
+        auto const head = m_head.load(std::memory_order_relaxed);
+        if (head - m_tail_cache + values.size() > SIZE)
+            m_tail_cache = m_tail.load(std::memory_order_acquire);
+        auto const count = std::min(values.size(), SIZE - (head - m_tail_cache));
+        copy_in(head, values.first(count));
+        m_head.store(head + count, std::memory_order_release);
+        return count;
+    }
+
+    // Consumer: take the oldest value, false when empty
+    auto pop(T& value) -> bool {
+        auto const tail = m_tail.load(std::memory_order_relaxed);
+        if (tail == m_head_cache) {
+            m_head_cache = m_head.load(std::memory_order_acquire);
+            if (tail == m_head_cache) return false;
+        }
+        value = m_buffer[tail & mask];
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Consumer: take up to out.size() of the oldest values, returns how
+     * many. One acquire and one release for the whole batch, the values are
+     * copied in at most two contiguous runs.
+     */
+    auto pop(std::span<T> out) -> usize {
+        auto const tail = m_tail.load(std::memory_order_relaxed);
+        if (m_head_cache - tail < out.size())
+            m_head_cache = m_head.load(std::memory_order_acquire);
+        auto const count = std::min(out.size(), m_head_cache - tail);
+        copy_out(tail, out.first(count));
+        m_tail.store(tail + count, std::memory_order_release);
+        return count;
+    }
+
+    // Either side, exact only when the other side is idle
+    auto size() const -> usize {
+        auto const tail = m_tail.load(std::memory_order_acquire);
+        return m_head.load(std::memory_order_acquire) - tail;
+    }
+    auto empty() const -> bool { return size() == 0; }
+
+  private:
+    static constexpr usize mask = SIZE - 1;
+
+    auto copy_in(usize const& head, std::span<T const> values) -> void {
+        auto const start = head & mask;
+        auto const first = std::min(values.size(), SIZE - start);
+        std::copy_n(values.data(), first, m_buffer.data() + start);
+        std::copy_n(values.data() + first, values.size() - first, m_buffer.data());
+    }
+
+    auto copy_out(usize const& tail, std::span<T> out) const -> void {
+        auto const start = tail & mask;
+        auto const first = std::min(out.size(), SIZE - start);
+        std::copy_n(m_buffer.data() + start, first, out.data());
+        std::copy_n(m_buffer.data(), out.size() - first, out.data() + first);
+    }
+
+  private:
+    alignas(64) std::atomic<usize> m_head{0};  // written by the producer
+    usize m_tail_cache = 0;                    // the producer's copy of m_tail
+    alignas(64) std::atomic<usize> m_tail{0};  // written by the consumer
+    usize m_head_cache = 0;                    // the consumer's copy of m_head
+    alignas(64) std::array<T, SIZE> m_buffer{};
+};
+}  // namespace nrv
@@ -0,0 +1,127 @@
+/**
+ * @file   stft.hpp
+ * @author Pratchaya Khansomboon (pratchaya.k.git@gmail.com)
+ * @brief  Streaming short-time Fourier transform reading its frames from a
+ *         ring buffer.
+ * @date   2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+#include <algorithm>
+#include <complex>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include "types.hpp"
+#include "ring.hpp"
+#include "rfft.hpp"
+#include "window.hpp"
+
+namespace nrv {
+/**
+ * Short-time Fourier transform of a sample stream that is written into an
+ * nrv::ring, or an nrv::mirrored_ring on the host. The ring is the history,
+ * the overlap between frames is never copied: every hop samples a frame of the
+ * newest frame_size samples is read straight out of the ring, multiplied with
+ * the precomputed window and transformed with a real FFT. The frame buffer,
+ * the spectrum and the FFT scratch are allocated once by the constructor.
+ *
+ * The caller tells update() how many samples were enqueued since the last
+ * call. The first frame ends at sample frame_size - 1 of the stream, frame k
+ * at frame_size - 1 + k * hop. A frame whose samples were already overwritten,
+ * because update() wasn't called for longer than the ring can hold, is counted
+ * as dropped. The spectrum is unnormalised, bin k of a sine with amplitude A
+ * on bin k is A * sum(window) / 2.
+ */
+template <typename T>
+class stft {
+  public:
+    using value_type   = T;
+    using complex_type = std::complex<T>;
+
+    stft(usize const& frame_size, usize const& hop, window_type const& window = window_type::hann)
+        : m_plan(frame_size), m_hop(hop), m_window(make_window<T>(window, frame_size)),
+          m_frame(frame_size), m_bins(m_plan.bins()), m_scratch(m_plan.scratch_size()),
+          m_next(frame_size - 1) {
+        if (hop == 0)
+            throw std::invalid_argument("stft: hop needs to be at least 1");
+    }
+
+    auto frame_size() const -> usize { return m_plan.size(); }
+    auto hop() const -> usize { return m_hop; }
+    auto bins() const -> usize { return m_plan.bins(); }
+    auto window() const -> std::span<T const> { return m_window; }
+
+    // Frames emitted and dropped since construction or reset()
+    auto frames() const -> usize { return m_frames; }
+    auto dropped() const -> usize { return m_dropped; }
+
+    // Frequency of bin k for the sample rate fs
+    auto frequency(usize const& k, T const& fs) const -> T {
+        return T(k) * fs / T(frame_size());
+    }
+
+    // Start over with the next sample as the first one of the stream
+    auto reset() -> void {
+        m_seen    = 0;
+        m_next    = frame_size() - 1;
+        m_frames  = 0;
+        m_dropped = 0;
+    }
+
+    /**
+     * Call after `count` samples were enqueued to the ring, an nrv::ring or
+     * an nrv::mirrored_ring. Calls emit(std::span<complex_type const>) with
+     * the bins() values of every frame completed by the new samples, oldest
+     * first, and returns the number of frames emitted. The span is only
+     * valid during the call. A mirrored_ring hands out a frame as one
+     * contiguous window, the window multiply runs straight over it.
+     */
+    template <typename Ring, typename F>
+    auto update(Ring const& samples, usize const& count, F&& emit) -> usize {
+        auto const available = samples.size();
+        auto const N = frame_size();
+
+        m_seen += count;
+        usize emitted = 0;
+        for (; m_next < m_seen; m_next += m_hop) {
+            // Samples between the end of the frame and the newest sample
+            auto const lag = m_seen - 1 - m_next;
+            if (lag + N > available) {
+                m_dropped++;
+                continue;
+            }
+            if constexpr (requires { samples.window(lag, N); }) {
+                auto const frame = samples.window(lag, N);
+                for (usize n = 0; n < N; n++) m_frame[n] = T(frame[n]) * m_window[n];
+            } else {
+                for (usize n = 0; n < N; n++)
+                    m_frame[n] = T(samples.at_back(lag + N - 1 - n)) * m_window[n];
+            }
+            m_plan.execute(m_frame, m_bins, m_scratch);
+            m_frames++;
+            emitted++;
+            emit(std::span<complex_type const>(m_bins));
+        }
+        return emitted;
+    }
+
+  private:
+    rfft_plan<T> m_plan;
+    usize m_hop = 1;
+    std::vector<T> m_window{};
+    std::vector<T> m_frame{};
+    std::vector<complex_type> m_bins{};
+    std::vector<complex_type> m_scratch{};
+
+    usize m_seen    = 0;  // samples in the stream so far
+    usize m_next    = 0;  // stream index of the last sample of the next frame
+    usize m_frames  = 0;
+    usize m_dropped = 0;
+};
+}  // namespace nrv
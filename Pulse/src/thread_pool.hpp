@@ -0,0 +1,243 @@
+/**
+ * @file   thread_pool.hpp
+ * @author Pratchaya Khansomboon (pratchaya.k.git@gmail.com)
+ * @brief  Fork-join thread pool with work stealing for data parallel loops.
+ * @date   2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "types.hpp"
+
+namespace nrv {
+/**
+ * Thread pool that runs one parallel_for at a time. The loop is cut into
+ * chunks of `grain` iterations and every thread, the caller included, gets
+ * an equal contiguous range of chunks. A thread takes chunks from the front of
+ * its own range and when it runs dry steals from the back of the others'.
+ * A range is a single 64-bit word (first and last chunk) updated with
+ * compare-and-swap, so neither taking nor stealing locks and dispatching a
+ * loop doesn't allocate.
+ *
+ * A parallel_for called from inside a running loop runs serially on the
+ * calling thread.
+ *
+ * When fn throws the chunks nobody has started are dropped, parallel_for waits
+ * for the chunks still running and rethrows, the first exception of a worker
+ * if the calling thread didn't throw itself. The pool is ready for the next
+ * loop either way.
+ */
+class thread_pool {
+  public:
+    // threads is the total number of threads working on a loop, the caller
+    // included, so a pool of 1 runs everything on the calling thread
+    explicit thread_pool(usize threads = std::thread::hardware_concurrency())
+        : m_ranges(std::max<usize>(threads, 1)) {
+        for (usize i = 1; i < m_ranges.size(); i++)
+            m_workers.emplace_back([this, i] { worker(i); });
+    }
+    ~thread_pool() {
+        {
+            std::lock_guard lock{m_mutex};
+            m_stop = true;
+        }
+        m_wake.notify_all();
+        for (auto& w : m_workers) w.join();
+    }
+    thread_pool(thread_pool const&) = delete;
+    auto operator=(thread_pool const&) -> thread_pool& = delete;
+
+    auto size() const -> usize { return m_ranges.size(); }
+
+    /**
+     * Calls fn(first, last) for consecutive sub-ranges of [begin, end), at
+     * most `grain` iterations each, spread over the threads of the pool.
+     * Returns when every sub-range is done or throws what fn threw.
+     */
+    template <typename F>
+    auto parallel_for(usize const& begin, usize const& end, usize grain, F&& fn) -> void {
+        if (begin >= end) return;
+        grain = std::max<usize>(grain, 1);
+        auto const chunks = (end - begin + grain - 1) / grain;
+        if (size() == 1 || chunks == 1 || in_loop()) {
+            for (auto first = begin; first < end; first += grain)
+                fn(first, std::min(first + grain, end));
+            return;
+        }
+
+        using fn_type = std::remove_reference_t<F>;
+        std::lock_guard loop_lock{m_loop};
+        m_error = nullptr;
+        m_job = {
+            [](void* ctx, usize first, usize last) { (*static_cast<fn_type*>(ctx))(first, last); },
+            const_cast<void*>(static_cast<void const*>(std::addressof(fn))),
+            begin, end, grain,
+        };
+
+        // Equal share of chunks for every thread
+        auto const n = size();
+        for (usize i = 0; i < n; i++)
+            m_ranges[i].value.store(pack(chunks * i / n, chunks * (i + 1) / n), std::memory_order_relaxed);
+        m_pending.store(n - 1, std::memory_order_relaxed);
+        {
+            std::lock_guard lock{m_mutex};
+            m_generation++;
+        }
+        m_wake.notify_all();
+
+        {
+            // The workers call fn through m_job, it has to outlive them
+            join_guard join{*this};
+            run(0);
+            join.finished = true;
+        }
+        if (m_error) std::rethrow_exception(std::exchange(m_error, nullptr));
+    }
+
+  private:
+    struct job {
+        void (*call)(void*, usize, usize) = nullptr;
+        void* context = nullptr;
+        usize begin = 0;
+        usize end   = 0;
+        usize grain = 1;
+    };
+
+    // One range per thread on its own cache line, first chunk in the low
+    // 32 bits and one past the last chunk in the high 32 bits
+    struct alignas(64) range {
+        std::atomic<u64> value{0};
+    };
+
+    static constexpr auto pack(usize const& first, usize const& last) -> u64 {
+        return u64(first) | (u64(last) << 32);
+    }
+
+    static auto in_loop() -> bool& {
+        thread_local bool flag = false;
+        return flag;
+    }
+
+    // Marks the thread as running a loop until it leaves, also by exception
+    struct loop_scope {
+        loop_scope() { in_loop() = true; }
+        ~loop_scope() { in_loop() = false; }
+        loop_scope(loop_scope const&) = delete;
+        auto operator=(loop_scope const&) -> loop_scope& = delete;
+    };
+
+    // Waits for the workers at the end of a loop. Leaving by exception, the
+    // chunks nobody has started are dropped first.
+    struct join_guard {
+        thread_pool& pool;
+        bool finished = false;
+
+        ~join_guard() {
+            if (!finished) pool.cancel(nullptr);
+            std::unique_lock lock{pool.m_mutex};
+            pool.m_done.wait(lock, [this] { return pool.m_pending.load(std::memory_order_acquire) == 0; });
+        }
+    };
+
+    // Empties every range, a thread stops at its next take or steal. The
+    // first error is kept for the caller.
+    auto cancel(std::exception_ptr const& error) -> void {
+        for (auto& r : m_ranges) r.value.store(0, std::memory_order_relaxed);
+        if (!error) return;
+        std::lock_guard lock{m_mutex};
+        if (!m_error) m_error = error;
+    }
+
+    // Take a chunk from the front of the own range
+    auto take(usize const& self, usize& chunk) -> bool {
+        auto& r = m_ranges[self].value;
+        auto v = r.load(std::memory_order_relaxed);
+        while (true) {
+            auto const first = v & 0xFFFF'FFFF, last = v >> 32;
+            if (first >= last) return false;
+            if (r.compare_exchange_weak(v, pack(first + 1, last), std::memory_order_acq_rel)) {
+                chunk = first;
+                return true;
+            }
+        }
+    }
+
+    // Steal a chunk from the back of another thread's range
+    auto steal(usize const& self, usize& chunk) -> bool {
+        auto const n = size();
+        for (usize i = 1; i < n; i++) {
+            auto& r = m_ranges[(self + i) % n].value;
+            auto v = r.load(std::memory_order_relaxed);
+            while (true) {
+                auto const first = v & 0xFFFF'FFFF, last = v >> 32;
+                if (first >= last) break;
+                if (r.compare_exchange_weak(v, pack(first, last - 1), std::memory_order_acq_rel)) {
+                    chunk = last - 1;
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    auto run(usize const& self) -> void {
+        loop_scope const scope{};
+        auto const& j = m_job;
+        usize chunk = 0;
+        while (take(self, chunk) || steal(self, chunk)) {
+            auto const first = j.begin + chunk * j.grain;
+            j.call(j.context, first, std::min(first + j.grain, j.end));
+        }
+    }
+
+    auto worker(usize const& self) -> void {
+        u64 seen = 0;
+        while (true) {
+            {
+                std::unique_lock lock{m_mutex};
+                m_wake.wait(lock, [&] { return m_stop || m_generation != seen; });
+                if (m_stop) return;
+                seen = m_generation;
+            }
+            try {
+                run(self);
+            } catch (...) {
+                cancel(std::current_exception());
+            }
+            if (m_pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                std::lock_guard lock{m_mutex};
+                m_done.notify_one();
+            }
+        }
+    }
+
+  private:
+    std::vector<range>       m_ranges;
+    std::vector<std::thread> m_workers{};
+    job                      m_job{};
+
+    std::mutex              m_loop{};   // one parallel_for at a time
+    std::mutex              m_mutex{};
+    std::condition_variable m_wake{};
+    std::condition_variable m_done{};
+    std::atomic<usize>      m_pending{0};
+    std::exception_ptr      m_error{};  // first exception of a worker
+    u64                     m_generation = 0;
+    bool                    m_stop = false;
+};
+}  // namespace nrv
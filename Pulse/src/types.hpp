@@ -10,6 +10,7 @@
 #pragma once
 #include <cstdint>
 #include <cstddef>
+#include <compare>
 
 namespace nrv {
 using f32 = float;          // float 32-bit
@@ -28,6 +29,50 @@ using i64 = std::int64_t;   // integer 64-bit
 using usize = std::size_t;     // unsigned arch
 using isize = std::ptrdiff_t;  // signed   arch
 
+/**
+ * Signed fixed point of the range [-1, 1) in the integer I, all but the sign
+ * bit are fraction bits, products are formed in the twice as wide W. Adding,
+ * subtracting and multiplying saturate at the ends of the range instead of
+ * wrapping around, the product is rounded to nearest.
+ */
+template <typename I, typename W>
+struct fixed {
+    using raw_type  = I;
+    using wide_type = W;
+
+    static constexpr int fraction_bits = int(sizeof(I)) * 8 - 1;
+    static constexpr W raw_max = (W{1} << fraction_bits) - 1;
+    static constexpr W raw_min = -(W{1} << fraction_bits);
+
+    I raw = 0;
+
+    static constexpr auto saturate(W const& value) -> fixed {
+        return {I(value > raw_max ? raw_max : value < raw_min ? raw_min : value)};
+    }
+
+    // Rounded to nearest, saturated
+    static constexpr auto from(f64 const& value) -> fixed {
+        auto const scaled = value * f64(W{1} << fraction_bits);
+        if (scaled >= f64(raw_max)) return {I(raw_max)};
+        if (scaled <= f64(raw_min)) return {I(raw_min)};
+        return {I(scaled < 0.0 ? scaled - 0.5 : scaled + 0.5)};
+    }
+
+    template <typename F = f64>
+    constexpr auto to() const -> F { return F(raw) / F(W{1} << fraction_bits); }
+
+    friend constexpr auto operator+(fixed const& a, fixed const& b) -> fixed { return saturate(W(a.raw) + W(b.raw)); }
+    friend constexpr auto operator-(fixed const& a, fixed const& b) -> fixed { return saturate(W(a.raw) - W(b.raw)); }
+    friend constexpr auto operator-(fixed const& a) -> fixed { return saturate(-W(a.raw)); }
+    friend constexpr auto operator*(fixed const& a, fixed const& b) -> fixed {
+        return saturate((W(a.raw) * W(b.raw) + (W{1} << (fraction_bits - 1))) >> fraction_bits);
+    }
+    friend constexpr auto operator<=>(fixed const& a, fixed const& b) = default;
+};
+
+using q15 = fixed<i16, i32>;  // Q1.15 fixed point 16-bit
+using q31 = fixed<i32, i64>;  // Q1.31 fixed point 32-bit
+
 namespace max {
 u8  u8  = UINT8_MAX;
 u16 u16 = UINT16_MAX;
@@ -0,0 +1,50 @@
+/**
+ * @file   window.hpp
+ * @author Pratchaya Khansomboon (pratchaya.k.git@gmail.com)
+ * @brief  Window functions for spectral analysis and filter design.
+ * @date   2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ */
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+
+#include <numbers>
+#include <vector>
+
+#include "types.hpp"
+
+namespace nrv {
+enum class window_type {
+    rectangular,
+    hann,
+    hamming,
+    blackman,
+};
+
+/**
+ * Window of `size` values. The periodic window is the symmetric window of
+ * size + 1 values without the last one, it's the one to use with the DFT,
+ * e.g. overlapping Hann windows at a hop of size / 2 add up to a constant.
+ * Filter design uses the symmetric window.
+ */
+template <typename T>
+auto make_window(window_type const& type, usize const& size, bool const& periodic = true) -> std::vector<T> {
+    std::vector<T> w(size, T(1));
+    if (size < 2 || type == window_type::rectangular) return w;
+
+    auto const L = f64(periodic ? size : size - 1);
+    for (usize n = 0; n < size; n++) {
+        auto const x = 2.0 * std::numbers::pi * f64(n) / L;
+        switch (type) {
+            case window_type::rectangular: break;
+            case window_type::hann:        w[n] = T(0.5 - 0.5 * std::cos(x)); break;
+            case window_type::hamming:     w[n] = T(0.54 - 0.46 * std::cos(x)); break;
+            case window_type::blackman:    w[n] = T(0.42 - 0.5 * std::cos(x) + 0.08 * std::cos(2.0 * x)); break;
+        }
+    }
+    return w;
+}
+}  // namespace nrv